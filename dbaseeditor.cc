@@ -1,19 +1,218 @@
 #include "dbaseeditor.h"
 #include "dbaseeditorconstants.h"
+#include "dbaseeditorhighlighter.h"
+#include "dbaseeditortrace.h"
 
+#include <coreplugin/icore.h>
+
+#include <texteditor/syntaxhighlighter.h>
+#include <texteditor/textdocumentlayout.h>
 #include <texteditor/texteditoractionhandler.h>
 #include <texteditor/texteditorconstants.h>
-#include <texteditor/textdocument.h>
 
+#include <utils/fileutils.h>
+#include <utils/mimetypes/mimedatabase.h>
 #include <utils/qtcassert.h>
 
 #include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QScopedPointer>
+#include <QSettings>
+#include <QTextCodec>
+#include <QTextCursor>
+#include <QTextDocument>
 
 using namespace TextEditor;
 
 namespace dBaseEditor {
 namespace Internal {
 
+const char LargeFileThresholdKey[] = "dBaseEditor/LargeFileThresholdMB";
+const int DefaultLargeFileThresholdMB = 32;
+const qint64 LargeFileChunkSize = 4 * 1024 * 1024;
+
+static qint64 largeFileThreshold()
+{
+    int megabytes = DefaultLargeFileThresholdMB;
+    if (QSettings *settings = Core::ICore::settings())
+        megabytes = settings->value(LargeFileThresholdKey, DefaultLargeFileThresholdMB).toInt();
+    return qint64(qMax(1, megabytes)) * 1024 * 1024;
+}
+
+dBaseDocument::dBaseDocument()
+    : TextDocument(Constants::C_DBASEEDITOR_ID)
+{
+}
+
+Core::IDocument::OpenResult dBaseDocument::open(QString *errorString, const QString &fileName,
+                                                const QString &realFileName)
+{
+    if (QFileInfo(realFileName).size() < largeFileThreshold())
+        return TextDocument::open(errorString, fileName, realFileName);
+
+    // Same bookkeeping as TextDocument::open(), with the chunked loader
+    emit aboutToOpen(fileName, realFileName);
+    const OpenResult result = openLargeFile(errorString, fileName, realFileName);
+    if (result == OpenResult::Success) {
+        setMimeType(Utils::mimeTypeForFile(fileName).name());
+        emit openFinishedSuccessfully();
+    }
+    return result;
+}
+
+/**
+ * Reloads large files with the chunked loader as well; TextDocument would
+ * read them as a whole.
+ */
+bool dBaseDocument::reload(QString *errorString, ReloadFlag flag, ChangeType type)
+{
+    const QString fileName = filePath().toString();
+    if (flag == FlagIgnore || type == TypePermissions
+            || (!m_largeFile && QFileInfo(fileName).size() < largeFileThreshold())) {
+        return TextDocument::reload(errorString, flag, type);
+    }
+
+    emit aboutToReload();
+    auto documentLayout = qobject_cast<TextDocumentLayout *>(document()->documentLayout());
+    TextMarks marks;
+    if (documentLayout)
+        marks = documentLayout->documentClosing(); // removes text marks non-permanently
+
+    const bool success
+            = openLargeFile(errorString, fileName, fileName) == OpenResult::Success;
+
+    if (documentLayout)
+        documentLayout->documentReloaded(marks, this); // re-adds text marks
+    emit reloadFinished(success);
+    return success;
+}
+
+/**
+ * Decodes the file chunk by chunk straight from a memory map, so next to the
+ * document only one decoded chunk is held in memory at a time. Unless the
+ * file starts with a BOM it is decoded with the codec of the document, which
+ * keeps an encoding chosen by the user across reloads.
+ */
+Core::IDocument::OpenResult dBaseDocument::openLargeFile(QString *errorString,
+                                                         const QString &fileName,
+                                                         const QString &realFileName)
+{
+    DBASE_TRACE_SCOPE("dBaseDocument::openLargeFile");
+
+    QFile file(realFileName);
+    if (!file.open(QFile::ReadOnly)) {
+        if (errorString)
+            *errorString = file.errorString();
+        return OpenResult::ReadError;
+    }
+
+    const qint64 size = file.size();
+    uchar *data = size > 0 ? file.map(0, size) : 0;
+    if (size > 0 && !data) {
+        if (errorString)
+            *errorString = file.errorString();
+        return OpenResult::ReadError;
+    }
+
+    const QByteArray head = QByteArray::fromRawData(reinterpret_cast<const char *>(data),
+                                                    int(qMin<qint64>(size, 4096)));
+    QTextCodec *textCodec = QTextCodec::codecForUtfText(head, const_cast<QTextCodec *>(codec()));
+    setCodec(textCodec);
+
+    // The decoder drops the BOM, remember it for saving
+    const bool hasUtf8Bom = head.startsWith("\xef\xbb\xbf");
+    if (format().hasUtf8Bom != hasUtf8Bom)
+        switchUtf8Bom();
+
+    // Highlighting is done for the visible region by the editor widgets
+    if (SyntaxHighlighter *highlighter = syntaxHighlighter())
+        highlighter->setDocument(0);
+
+    QTextDocument *doc = document();
+    doc->setUndoRedoEnabled(false);
+    doc->clear();
+
+    // Like TextFileFormat, the first line break decides the line termination
+    // mode; only '\r' directly in front of '\n' is removed in CRLF mode.
+    bool modeDetected = false;
+    bool crlf = false;
+    bool pendingCarriageReturn = false;
+
+    QScopedPointer<QTextDecoder> decoder(textCodec->makeDecoder());
+    QTextCursor cursor(doc);
+    for (qint64 offset = 0; offset < size; offset += LargeFileChunkSize) {
+        const int length = int(qMin(LargeFileChunkSize, size - offset));
+        QString chunk = decoder->toUnicode(reinterpret_cast<const char *>(data + offset), length);
+
+        if (pendingCarriageReturn) {
+            chunk.prepend('\r');
+            pendingCarriageReturn = false;
+        }
+        if (!modeDetected) {
+            const int newline = chunk.indexOf('\n');
+            if (newline != -1) {
+                crlf = newline > 0 && chunk.at(newline - 1) == '\r';
+                modeDetected = true;
+            }
+        }
+        // A '\r' at the end of the chunk may belong to a "\r\n" split
+        // between this chunk and the next one
+        if ((crlf || !modeDetected) && offset + length < size && chunk.endsWith('\r')) {
+            chunk.chop(1);
+            pendingCarriageReturn = true;
+        }
+        if (crlf)
+            chunk.replace(QLatin1String("\r\n"), QLatin1String("\n"));
+
+        cursor.movePosition(QTextCursor::End);
+        cursor.insertText(chunk);
+    }
+    if (data)
+        file.unmap(data);
+
+    setLineTerminationMode(crlf ? Utils::TextFileFormat::CRLFLineTerminator
+                                : Utils::TextFileFormat::LFLineTerminator);
+
+    doc->setUndoRedoEnabled(true);
+    // Restored auto-save files stay modified, like in TextDocument::openImpl()
+    doc->setModified(fileName != realFileName);
+    setFilePath(Utils::FileName::fromUserInput(QFileInfo(fileName).absoluteFilePath()));
+
+    if (!m_largeFile) {
+        m_largeFile = true;
+        emit largeFileOpened();
+    }
+    return OpenResult::Success;
+}
+
+////////////////////////////////////////////////////////////////
+
+void dBaseEditorWidget::finalizeInitialization()
+{
+    auto doc = qobject_cast<dBaseDocument *>(textDocument());
+    QTC_ASSERT(doc, return);
+
+    if (doc->isLargeFile())
+        enterLargeFileMode();
+    else
+        connect(doc, &dBaseDocument::largeFileOpened, this, &dBaseEditorWidget::enterLargeFileMode);
+}
+
+void dBaseEditorWidget::enterLargeFileMode()
+{
+    if (m_largeFileMode)
+        return;
+    m_largeFileMode = true;
+
+    setCodeFoldingSupported(false);
+    setParenthesesMatchingEnabled(false);
+    setRevisionsVisible(false);
+    new dBaseVisibleRegionHighlighter(this);
+}
+
+////////////////////////////////////////////////////////////////
+
 dBaseEditorFactory::dBaseEditorFactory()
 {
     setId(Constants::C_DBASEEDITOR_ID);
@@ -28,7 +227,12 @@ dBaseEditorFactory::dBaseEditorFactory()
            | TextEditorActionHandler::UnCommentSelection
            | TextEditorActionHandler::UnCollapseAll);
            
-    setDocumentCreator([] { return new TextDocument(Constants::C_DBASEEDITOR_ID); });
+    setDocumentCreator([] {
+        DBASE_TRACE_SCOPE("dBaseEditorFactory::createDocument");
+        return new dBaseDocument;
+    });
+    setEditorWidgetCreator([] { return new dBaseEditorWidget; });
+    setSyntaxHighlighterCreator([] { return new dBaseHighlighter; });
     setCommentDefinition(Utils::CommentDefinition::HashStyle);
     setParenthesesMatchingEnabled(true);
     setMarksVisible(true);
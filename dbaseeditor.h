@@ -1,10 +1,52 @@
 #pragma once
 
+#include <texteditor/textdocument.h>
 #include <texteditor/texteditor.h>
 
 namespace dBaseEditor {
 namespace Internal {
 
+/**
+ * @brief Document that switches to large-file mode above a size threshold.
+ *
+ * In large-file mode the file is decoded chunk by chunk from a memory map,
+ * the document wide highlighter is detached and the editor widgets turn off
+ * folding and parentheses matching.
+ */
+class dBaseDocument : public TextEditor::TextDocument
+{
+    Q_OBJECT
+
+public:
+    dBaseDocument();
+
+    bool isLargeFile() const { return m_largeFile; }
+
+    OpenResult open(QString *errorString, const QString &fileName,
+                    const QString &realFileName) override;
+    bool reload(QString *errorString, ReloadFlag flag, ChangeType type) override;
+
+signals:
+    void largeFileOpened();
+
+private:
+    OpenResult openLargeFile(QString *errorString, const QString &fileName,
+                             const QString &realFileName);
+
+    bool m_largeFile = false;
+};
+
+class dBaseEditorWidget : public TextEditor::TextEditorWidget
+{
+public:
+    void finalizeInitialization() override;
+
+private:
+    void enterLargeFileMode();
+
+    bool m_largeFileMode = false;
+};
+
 class dBaseEditorFactory: public TextEditor::TextEditorFactory
 {
 public:
@@ -7,10 +7,31 @@ HEADERS += \
     dbaseeditorplugin.h \
     dbaseeditor.h \
     dbaseeditorconstants.h \
-    dbaseeditorscanner.h
+    dbaseeditordependencygraph.h \
+    dbaseeditorhighlighter.h \
+    dbaseeditorpathtable.h \
+    dbaseeditorprofiler.h \
+    dbaseeditorproject.h \
+    dbaseeditorrunconfiguration.h \
+    dbaseeditorscanner.h \
+    dbaseeditortrace.h \
+    dbaseformattoken.h
     
 SOURCES += \
     dbaseeditorplugin.cc \
     dbaseeditor.cc \
-    dbaseeditorscanner.cc
+    dbaseeditordependencygraph.cc \
+    dbaseeditorhighlighter.cc \
+    dbaseeditorpathtable.cc \
+    dbaseeditorprofiler.cc \
+    dbaseeditorproject.cc \
+    dbaseeditorrunconfiguration.cc \
+    dbaseeditorscanner.cc \
+    dbaseeditortrace.cc
+
+# Tests and benchmarks, run with: qtcreator -test dBaseEditor
+equals(TEST, 1) {
+    HEADERS += dbaseeditorbenchmark.h dbaseeditortest.h
+    SOURCES += dbaseeditorbenchmark.cc dbaseeditortest.cc
+}
     
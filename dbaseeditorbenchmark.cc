@@ -0,0 +1,387 @@
+#include "dbaseeditorbenchmark.h"
+#include "dbaseeditorproject.h"
+#include "dbaseeditorrunconfiguration.h"
+#include "dbaseeditorscanner.h"
+
+#include <utils/fileutils.h>
+#include <utils/qtcassert.h>
+
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+#include <QTest>
+#include <QTextStream>
+
+#include <algorithm>
+
+using namespace Utils;
+
+namespace dBaseEditor {
+namespace Internal {
+
+const char BenchmarkRootVariable[] = "DBASE_BENCHMARK_ROOT";
+const int FilesPerDirectory = 100;
+
+template <typename Function>
+static QVector<qint64> measure(int iterations, Function function)
+{
+    QVector<qint64> samples;
+    QElapsedTimer timer;
+    for (int i = 0; i < iterations; ++i) {
+        timer.start();
+        function();
+        samples.append(timer.nsecsElapsed());
+    }
+    return samples;
+}
+
+static bool writeFile(const QString &fileName, const QString &contents)
+{
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+    QFile file(fileName);
+    if (!file.open(QFile::WriteOnly | QFile::Text))
+        return false;
+    file.write(contents.toUtf8());
+    return true;
+}
+
+static QString readFile(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly | QFile::Text))
+        return QString();
+    return QString::fromUtf8(file.readAll());
+}
+
+////////////////////////////////////////////////////////////////
+
+dBaseCorpusGenerator::dBaseCorpusGenerator(const QString &directory)
+    : m_directory(directory)
+{
+}
+
+/**
+ * Writes \a entryCount files plus a project file listing them and returns the
+ * project file name. Files that already exist are reused.
+ */
+QString dBaseCorpusGenerator::generateProject(int entryCount)
+{
+    const QString name = QString("corpus-%1").arg(entryCount);
+    const QString projectFile = QString("%1/%2/%2.dbgprj").arg(m_directory, name);
+    if (QFileInfo::exists(projectFile))
+        return projectFile;
+
+    QString projectContents;
+    QTextStream project(&projectContents);
+    for (int i = 0; i < entryCount; ++i) {
+        const bool isForm = i % 20 == 19;
+        const QString relativePath = QString("src/dir%1/file%2.%3")
+                .arg(i / FilesPerDirectory, 4, 10, QChar('0'))
+                .arg(i, 6, 10, QChar('0'))
+                .arg(isForm ? "dfm" : "prg");
+        const QString absolutePath = QString("%1/%2/%3").arg(m_directory, name, relativePath);
+
+        if (!QFileInfo::exists(absolutePath)) {
+            writeFile(absolutePath, isForm
+                      ? QString("** dBase form %1\n").arg(i)
+                      : QString("* dBase source %1\n? \"file %1\"\n").arg(i));
+        }
+
+        if (i % 10 == 9)
+            project << "$$(" << BenchmarkRootVariable << ")/" << name << '/' << relativePath << '\n';
+        else
+            project << relativePath << '\n';
+    }
+    project.flush();
+
+    writeFile(projectFile, projectContents);
+    return projectFile;
+}
+
+/**
+ * Writes a .prg source of \a lineCount lines made of procedures, loops,
+ * string literals and comments, and returns its file name.
+ */
+QString dBaseCorpusGenerator::generateSource(int lineCount)
+{
+    const QString fileName = QString("%1/source-%2.prg").arg(m_directory).arg(lineCount);
+    if (QFileInfo::exists(fileName))
+        return fileName;
+
+    QString contents;
+    QTextStream out(&contents);
+    int line = 0;
+    for (int procedure = 0; line < lineCount; ++procedure) {
+        out << "PROCEDURE Proc" << procedure << "(nCount, cName)\n";
+        out << "   LOCAL nIndex, cText  && locals\n";
+        out << "   cText = \"Procedure " << procedure << "\"\n";
+        out << "   FOR nIndex = 1 TO nCount\n";
+        out << "      IF MOD(nIndex, 2) = 0 .AND. .NOT. EMPTY(cName)\n";
+        out << "         ? cText + STR(nIndex * 3.14)\n";
+        out << "      ELSE\n";
+        out << "         // odd iteration\n";
+        out << "         cText = cText + 'x'\n";
+        out << "      ENDIF\n";
+        out << "   NEXT\n";
+        out << "RETURN nCount\n";
+        out << "\n";
+        line += 13;
+    }
+    out.flush();
+
+    writeFile(fileName, contents);
+    return fileName;
+}
+
+/**
+ * Writes a .dfm form with \a controlCount controls and returns its file name.
+ */
+QString dBaseCorpusGenerator::generateForm(int controlCount)
+{
+    const QString fileName = QString("%1/form-%2.dfm").arg(m_directory).arg(controlCount);
+    if (QFileInfo::exists(fileName))
+        return fileName;
+
+    QString contents;
+    QTextStream out(&contents);
+    out << "** END HEADER -- do not remove this line\n";
+    out << "CLASS BenchForm OF FORM\n";
+    out << "   with (this)\n";
+    out << "      height = 600\n";
+    out << "      width = 800\n";
+    out << "      text = \"Benchmark form\"\n";
+    out << "   endwith\n\n";
+    for (int i = 0; i < controlCount; ++i) {
+        out << "   this.ENTRY" << i << " = new ENTRYFIELD(this)\n";
+        out << "   with (this.ENTRY" << i << ")\n";
+        out << "      height = 22\n";
+        out << "      left = " << (i % 10) * 80 << "\n";
+        out << "      top = " << (i / 10) * 24 << "\n";
+        out << "      value = \"Entry " << i << "\"\n";
+        out << "   endwith\n\n";
+    }
+    out << "ENDCLASS\n";
+    out.flush();
+
+    writeFile(fileName, contents);
+    return fileName;
+}
+
+////////////////////////////////////////////////////////////////
+
+void dBaseBenchmark::initTestCase()
+{
+    QVERIFY(m_corpusDir.isValid());
+    qputenv(BenchmarkRootVariable, m_corpusDir.path().toLocal8Bit());
+
+    bool ok = false;
+    const int iterations = qEnvironmentVariableIntValue("DBASE_BENCHMARK_ITERATIONS", &ok);
+    if (ok && iterations > 0)
+        m_iterations = iterations;
+    const int maxEntries = qEnvironmentVariableIntValue("DBASE_BENCHMARK_MAX_ENTRIES", &ok);
+    if (ok && maxEntries > 0)
+        m_maxEntries = maxEntries;
+}
+
+void dBaseBenchmark::cleanupTestCase()
+{
+    QJsonObject root;
+    root.insert("benchmark", QLatin1String("dBaseEditor"));
+    root.insert("timestamp", QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    root.insert("iterations", m_iterations);
+    root.insert("results", m_results);
+
+    QString outputFile = QString::fromLocal8Bit(qgetenv("DBASE_BENCHMARK_OUTPUT"));
+    if (outputFile.isEmpty())
+        outputFile = "dbase-benchmark.json";
+
+    FileSaver saver(outputFile, QIODevice::Text);
+    saver.write(QJsonDocument(root).toJson());
+    QVERIFY2(saver.finalize(), qPrintable(saver.errorString()));
+}
+
+void dBaseBenchmark::addSizes(const QList<int> &sizes)
+{
+    QTest::addColumn<int>("size");
+    for (int size : sizes) {
+        if (size <= m_maxEntries)
+            QTest::newRow(qPrintable(QString::number(size))) << size;
+    }
+}
+
+dBaseProject *dBaseBenchmark::createProject(int entryCount)
+{
+    dBaseCorpusGenerator generator(m_corpusDir.path());
+    const QString projectFile = generator.generateProject(entryCount);
+    return new dBaseProject(FileName::fromString(projectFile));
+}
+
+void dBaseBenchmark::record(const QString &name, int size, QVector<qint64> samples)
+{
+    QTC_ASSERT(!samples.isEmpty(), return);
+    std::sort(samples.begin(), samples.end());
+
+    qint64 total = 0;
+    for (qint64 sample : samples)
+        total += sample;
+
+    QJsonObject result;
+    result.insert("name", name);
+    result.insert("size", size);
+    result.insert("minMs", samples.first() / 1e6);
+    result.insert("medianMs", samples.at(samples.size() / 2) / 1e6);
+    result.insert("meanMs", total / 1e6 / samples.size());
+    result.insert("maxMs", samples.last() / 1e6);
+    m_results.append(result);
+}
+
+void dBaseBenchmark::parseProject_data()
+{
+    addSizes({ 1000, 10000, 100000 });
+}
+
+void dBaseBenchmark::parseProject()
+{
+    QFETCH(int, size);
+    QScopedPointer<dBaseProject> project(createProject(size));
+
+    record("parseProject", size, measure(m_iterations, [&project] {
+        project->parseProject();
+    }));
+    QCOMPARE(project->m_files.size(), size + 1);
+}
+
+void dBaseBenchmark::processEntries_data()
+{
+    addSizes({ 1000, 10000, 100000 });
+}
+
+void dBaseBenchmark::processEntries()
+{
+    QFETCH(int, size);
+    QScopedPointer<dBaseProject> project(createProject(size));
+    project->parseProject();
+    const QStringList rawFileList = project->m_rawFileList;
+
+    QVector<PathTable::Id> files;
+    record("processEntries", size, measure(m_iterations, [&] {
+        QHash<PathTable::Id, int> map;
+        files = project->processEntries(rawFileList, &map);
+    }));
+    QCOMPARE(files.size(), size + 1);
+}
+
+void dBaseBenchmark::refresh_data()
+{
+    addSizes({ 1000, 10000, 100000 });
+}
+
+void dBaseBenchmark::refresh()
+{
+    QFETCH(int, size);
+    QScopedPointer<dBaseProject> project(createProject(size));
+
+    record("refresh", size, measure(m_iterations, [&project] {
+        project->refresh();
+    }));
+    QCOMPARE(project->files(ProjectExplorer::Project::AllFiles).size(), size + 1);
+}
+
+void dBaseBenchmark::runConfigurationDiscovery_data()
+{
+    addSizes({ 1000, 10000, 100000 });
+}
+
+void dBaseBenchmark::runConfigurationDiscovery()
+{
+    QFETCH(int, size);
+    QScopedPointer<dBaseProject> project(createProject(size));
+    project->refresh();
+
+    QList<Core::Id> ids;
+    record("runConfigurationDiscovery", size, measure(m_iterations, [&] {
+        ids = runConfigurationIdsForProject(project.data());
+    }));
+    QCOMPARE(ids.size(), size + 1);
+}
+
+void dBaseBenchmark::pathMemory_data()
+{
+    addSizes({ 1000, 10000, 100000 });
+}
+
+/**
+ * Compares the memory held for the project's file paths with the layout
+ * before the path table, where every file node stored its absolute path and
+ * a separately allocated display name. The file nodes share their path
+ * buffer with the table, which is verified here. previousLayoutBytes only
+ * counts those two strings per file; tableBytes also covers the arrays and
+ * the lookup hash of the table.
+ */
+void dBaseBenchmark::pathMemory()
+{
+    QFETCH(int, size);
+    QScopedPointer<dBaseProject> project(createProject(size));
+    project->refresh();
+
+    const PathTable &paths = *project->m_paths;
+    QSet<const QChar *> tableBuffers;
+    qint64 previousLayoutBytes = 0;
+    const QDir projectDir(project->projectDirectory().toString());
+    for (PathTable::Id id : project->m_files) {
+        const QString &path = paths.path(id);
+        tableBuffers.insert(path.constData());
+        previousLayoutBytes += PathTable::stringMemoryUsage(path)
+                + PathTable::stringMemoryUsage(projectDir.relativeFilePath(path));
+    }
+
+    int sharedNodePaths = 0;
+    for (const QString &filePath : project->files(ProjectExplorer::Project::AllFiles)) {
+        if (tableBuffers.contains(filePath.constData()))
+            ++sharedNodePaths;
+    }
+    QCOMPARE(sharedNodePaths, size + 1);
+
+    QJsonObject result;
+    result.insert("name", QLatin1String("pathMemory"));
+    result.insert("size", size);
+    result.insert("tableEntries", paths.size());
+    result.insert("tableBytes", double(paths.memoryUsage()));
+    result.insert("previousLayoutBytes", double(previousLayoutBytes));
+    m_results.append(result);
+}
+
+void dBaseBenchmark::scanner_data()
+{
+    QTest::addColumn<QString>("kind");
+    QTest::addColumn<int>("size");
+    QTest::newRow("prg-10000") << QString("prg") << 10000;
+    QTest::newRow("prg-100000") << QString("prg") << 100000;
+    QTest::newRow("prg-1000000") << QString("prg") << 1000000;
+    QTest::newRow("dfm-1000") << QString("dfm") << 1000;
+    QTest::newRow("dfm-10000") << QString("dfm") << 10000;
+}
+
+void dBaseBenchmark::scanner()
+{
+    QFETCH(QString, kind);
+    QFETCH(int, size);
+
+    dBaseCorpusGenerator generator(m_corpusDir.path());
+    const QString text = readFile(kind == "prg" ? generator.generateSource(size)
+                                                : generator.generateForm(size));
+    QVERIFY(!text.isEmpty());
+
+    record("scanner-" + kind, size, measure(m_iterations, [&text] {
+        Scanner scanner(text.constData(), text.size());
+        while (scanner.read().format() != Format_EndOfBlock) {}
+    }));
+}
+
+}  // namespace Internal
+}  // namespace dBaseEditor
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <QJsonArray>
+#include <QObject>
+#include <QTemporaryDir>
+
+namespace dBaseEditor {
+namespace Internal {
+
+class dBaseProject;
+
+/**
+ * @brief Generates synthetic dBase corpora on disk: a .dbgprj project file,
+ *        nested .prg sources, .dfm forms and one large .prg source.
+ *
+ * Every tenth project entry is written as $$(DBASE_BENCHMARK_ROOT)/...,
+ * which is set to the corpus directory, so the environment expansion in
+ * dBaseProject::processEntries() is exercised as well.
+ */
+class dBaseCorpusGenerator
+{
+public:
+    explicit dBaseCorpusGenerator(const QString &directory);
+
+    QString generateProject(int entryCount);
+    QString generateSource(int lineCount);
+    QString generateForm(int controlCount);
+
+private:
+    QString m_directory;
+};
+
+/**
+ * @brief Benchmarks for project load, tree construction, run configuration
+ *        discovery, path memory and the scanner.
+ *
+ * Run with "qtcreator -test dBaseEditor" on a build with TEST=1. The results
+ * are written as JSON to $DBASE_BENCHMARK_OUTPUT (default:
+ * dbase-benchmark.json in the working directory) so they can be compared
+ * between commits. Projects above $DBASE_BENCHMARK_MAX_ENTRIES entries
+ * (default: 10000) are skipped; set it to 100000 for the largest corpus.
+ */
+class dBaseBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void parseProject_data();
+    void parseProject();
+    void processEntries_data();
+    void processEntries();
+    void refresh_data();
+    void refresh();
+    void runConfigurationDiscovery_data();
+    void runConfigurationDiscovery();
+    void pathMemory_data();
+    void pathMemory();
+    void scanner_data();
+    void scanner();
+
+private:
+    void addSizes(const QList<int> &sizes);
+    dBaseProject *createProject(int entryCount);
+    void record(const QString &name, int size, QVector<qint64> samples);
+
+    QTemporaryDir m_corpusDir;
+    QJsonArray m_results;
+    int m_iterations = 5;
+    int m_maxEntries = 10000;
+};
+
+}  // namespace Internal
+}  // namespace dBaseEditor
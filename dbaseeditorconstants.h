@@ -11,5 +11,12 @@ const char C_EDITOR_DISPLAY_NAME[] = QT_TRANSLATE_NOOP("OpenWith::Editors", "dBa
 const char C_DBASE_MIMETYPE[] = "text/x-dbase";
 const char C_DBASE_MIME_ICON[] = "text-x-dbase";
 
+const char C_DBASE_PROFILE_RUN_MODE[] = "dBaseEditor.ProfileRunMode";
+const char C_DBASE_PROFILE_ACTION_ID[] = "dBaseEditor.ProfileScript";
+const char C_DBASE_PROFILE_MARK_CATEGORY[] = "dBaseEditor.ProfileMark";
+const char C_DBASE_PROFILE_FILE_ENV[] = "DBASE_PROFILE_FILE";
+
+const char C_DBASE_TRACE_ACTION_ID[] = "dBaseEditor.RecordTrace";
+
 }  // namespace Constants
 }  // namespace dBaseEditor
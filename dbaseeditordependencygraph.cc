@@ -0,0 +1,352 @@
+#include "dbaseeditordependencygraph.h"
+#include "dbaseeditorscanner.h"
+#include "dbaseeditortrace.h"
+
+#include <coreplugin/editormanager/editormanager.h>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextCodec>
+
+#include <climits>
+
+namespace dBaseEditor {
+namespace Internal {
+
+static QString stripQuotes(QString name)
+{
+    name = name.trimmed();
+    if (name.size() >= 2) {
+        const QChar first = name.at(0);
+        const QChar last = name.at(name.size() - 1);
+        if ((first == '"' && last == '"') || (first == '\'' && last == '\'')
+                || (first == '<' && last == '>') || (first == '[' && last == ']')) {
+            name = name.mid(1, name.size() - 2).trimmed();
+        }
+    }
+    return name;
+}
+
+// dBase accepts commands abbreviated to their first four letters
+static bool isCommand(const QString &word, const char *command)
+{
+    const QString upper = word.toUpper();
+    return upper.size() >= 4 && QString::fromLatin1(command).startsWith(upper);
+}
+
+DependencyGraph::DependencyGraph(PathTable *paths)
+    : m_paths(paths)
+{
+}
+
+/**
+ * Brings the graph up to date with the project \a files: changed files are
+ * rescanned, new dependencies outside of the project are scanned as well.
+ * Returns the changed files together with all files depending on them.
+ */
+QSet<PathTable::Id> DependencyGraph::update(const QVector<PathTable::Id> &files)
+{
+    DBASE_TRACE_SCOPE("DependencyGraph::update");
+
+    QSet<PathTable::Id> projectFiles;
+    QSet<PathTable::Id> changed;
+    for (PathTable::Id id : files) {
+        projectFiles.insert(id);
+        if (rescan(id))
+            changed.insert(id);
+    }
+
+    // Files outside of the project are kept while something depends on them
+    for (PathTable::Id id : m_files.keys()) {
+        if (projectFiles.contains(id))
+            continue;
+        if (m_dependents.value(id).isEmpty()) {
+            removeEdges(id, m_files.value(id));
+            m_files.remove(id);
+            changed.insert(id);
+        } else if (rescan(id)) {
+            changed.insert(id);
+        }
+    }
+
+    QVector<PathTable::Id> pending = m_dependents.keys().toVector();
+    while (!pending.isEmpty()) {
+        const PathTable::Id id = pending.takeLast();
+        if (m_files.contains(id))
+            continue;
+        rescan(id);
+        changed.insert(id);
+        const FileEntry &entry = m_files.value(id);
+        pending += entry.procedures;
+        pending += entry.includes;
+    }
+
+    const QSet<PathTable::Id> affected = affectedFiles(changed);
+    invalidate(affected);
+    return affected;
+}
+
+/**
+ * Rescans \a id after it was saved, regardless of its modification time,
+ * which may not have changed within the file system's granularity. When the
+ * dependencies or definitions of \a id changed, returns it together with all
+ * files depending on it, whose memoized definitions are dropped; otherwise
+ * returns an empty set.
+ */
+QSet<PathTable::Id> DependencyGraph::fileChanged(PathTable::Id id)
+{
+    if (!rescan(id, true))
+        return QSet<PathTable::Id>();
+
+    const QSet<PathTable::Id> affected = affectedFiles({ id });
+    invalidate(affected);
+    return affected;
+}
+
+QVector<PathTable::Id> DependencyGraph::dependencies(PathTable::Id id) const
+{
+    const FileEntry entry = m_files.value(id);
+    return entry.procedures + entry.includes;
+}
+
+QSet<PathTable::Id> DependencyGraph::dependents(PathTable::Id id) const
+{
+    QSet<PathTable::Id> result = affectedFiles({ id });
+    result.remove(id);
+    return result;
+}
+
+QSet<PathTable::Id> DependencyGraph::affectedFiles(const QSet<PathTable::Id> &changed) const
+{
+    QSet<PathTable::Id> result = changed;
+    QVector<PathTable::Id> pending = changed.toList().toVector();
+    while (!pending.isEmpty()) {
+        const PathTable::Id id = pending.takeLast();
+        for (PathTable::Id dependent : m_dependents.value(id)) {
+            if (!result.contains(dependent)) {
+                result.insert(dependent);
+                pending.append(dependent);
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * Returns the preprocessor definitions visible in \a id: those of the
+ * included files, overridden by the file's own #define entries. An include
+ * cycle is cut where it leads back to a file that is already being expanded.
+ */
+Definitions DependencyGraph::definitions(PathTable::Id id)
+{
+    QHash<PathTable::Id, int> visiting;
+    int cycleDepth = INT_MAX;
+    return definitions(id, &visiting, &cycleDepth);
+}
+
+/**
+ * \a visiting maps the files being expanded to their depth. \a cycleDepth is
+ * lowered to the depth of the shallowest file a cycle was cut at. A result
+ * that depends on a cut above its own depth differs with the file the query
+ * started from, so it is not memoized.
+ */
+Definitions DependencyGraph::definitions(PathTable::Id id, QHash<PathTable::Id, int> *visiting,
+                                         int *cycleDepth)
+{
+    auto memo = m_expandedDefinitions.constFind(id);
+    if (memo != m_expandedDefinitions.constEnd())
+        return memo.value();
+
+    // Include cycle
+    auto cut = visiting->constFind(id);
+    if (cut != visiting->constEnd()) {
+        *cycleDepth = qMin(*cycleDepth, cut.value());
+        return Definitions();
+    }
+
+    if (!m_files.contains(id))
+        rescan(id);
+
+    const int depth = visiting->size();
+    visiting->insert(id, depth);
+    int includesCycleDepth = INT_MAX;
+    const FileEntry entry = m_files.value(id);
+    Definitions result;
+    for (PathTable::Id include : entry.includes) {
+        const Definitions included = definitions(include, visiting, &includesCycleDepth);
+        for (auto it = included.constBegin(); it != included.constEnd(); ++it)
+            result.insert(it.key(), it.value());
+    }
+    for (auto it = entry.definitions.constBegin(); it != entry.definitions.constEnd(); ++it)
+        result.insert(it.key(), it.value());
+    visiting->remove(id);
+
+    if (includesCycleDepth >= depth)
+        m_expandedDefinitions.insert(id, result);
+    *cycleDepth = qMin(*cycleDepth, includesCycleDepth);
+    return result;
+}
+
+/**
+ * Scans \a id again when its modification time differs from the last scan,
+ * or always when \a force is set. Returns whether the dependencies or
+ * definitions of the file changed.
+ */
+bool DependencyGraph::rescan(PathTable::Id id, bool force)
+{
+    const QFileInfo fileInfo(m_paths->path(id));
+    const qint64 lastModified = fileInfo.exists()
+            ? fileInfo.lastModified().toMSecsSinceEpoch() : -1;
+
+    auto it = m_files.find(id);
+    const bool known = it != m_files.end();
+    if (known && !force && it.value().lastModified == lastModified)
+        return false;
+
+    FileEntry entry;
+    entry.lastModified = lastModified;
+    if (lastModified != -1)
+        scanFile(id, &entry);
+
+    if (known) {
+        if (it.value().sameContents(entry)) {
+            it.value().lastModified = lastModified;
+            return false;
+        }
+        removeEdges(id, it.value());
+    }
+
+    addEdges(id, entry);
+    m_files.insert(id, entry);
+    return true;
+}
+
+/**
+ * Collects the statements of \a id from the scanner output. A statement
+ * ends at a line break unless the line ends with ';'.
+ */
+void DependencyGraph::scanFile(PathTable::Id id, FileEntry *entry)
+{
+    DBASE_TRACE_SCOPE("DependencyGraph::scanFile");
+
+    QFile file(m_paths->path(id));
+    if (!file.open(QFile::ReadOnly))
+        return;
+    const QString text = Core::EditorManager::defaultTextCodec()->toUnicode(file.readAll());
+
+    Scanner scanner(text.constData(), text.size());
+    auto value = [&scanner](const FormatToken &tk) { return scanner.value(tk); };
+    auto range = [&text](const FormatToken &from, const FormatToken &to) {
+        return text.mid(from.begin(), to.end() - from.begin());
+    };
+
+    QVector<FormatToken> statement;
+    auto parseStatement = [&] {
+        if (statement.isEmpty())
+            return;
+
+        const FormatToken &first = statement.first();
+        if (first.format() == Format_Preprocessor) {
+            const QString directive = value(first).toLower();
+            if (directive == "#include" && statement.size() > 1) {
+                const PathTable::Id include
+                        = resolve(id, stripQuotes(range(statement.at(1), statement.last())), ".h");
+                if (include != PathTable::InvalidId)
+                    entry->includes.append(include);
+            } else if (directive == "#define" && statement.size() > 1) {
+                const QString definition = statement.size() > 2
+                        ? range(statement.at(2), statement.last()).simplified() : QString();
+                entry->definitions.insert(value(statement.at(1)), definition);
+            }
+        } else if (statement.size() > 3 && value(first).toUpper() == "SET"
+                   && isCommand(value(statement.at(1)), "PROCEDURE")
+                   && value(statement.at(2)).toUpper() == "TO") {
+            int last = statement.size() - 1;
+            if (value(statement.at(last)).toUpper() == "ADDITIVE")
+                --last;
+            if (last >= 3) {
+                const QString names = range(statement.at(3), statement.at(last));
+                for (const QString &name : names.split(',')) {
+                    const PathTable::Id procedure = resolve(id, stripQuotes(name), ".prg");
+                    if (procedure != PathTable::InvalidId)
+                        entry->procedures.append(procedure);
+                }
+            }
+        }
+        statement.clear();
+    };
+
+    bool continuation = false;
+    FormatToken tk;
+    while ((tk = scanner.read()).format() != Format_EndOfBlock) {
+        if (tk.format() == Format_Whitespace) {
+            if (QStringRef(&text, tk.begin(), tk.length()).indexOf('\n') != -1) {
+                if (!continuation)
+                    parseStatement();
+                continuation = false;
+            }
+        } else if (tk.format() == Format_Operator && text.at(tk.begin()) == ';') {
+            continuation = true;
+        } else if (tk.format() != Format_Comment) {
+            statement.append(tk);
+        }
+    }
+    parseStatement();
+}
+
+/**
+ * Resolves \a name relative to the directory of \a from, then to the
+ * project directory. Without a suffix \a defaultSuffix is tried as well.
+ */
+PathTable::Id DependencyGraph::resolve(PathTable::Id from, QString name,
+                                       const QString &defaultSuffix)
+{
+    name = QDir::fromNativeSeparators(name);
+    if (name.isEmpty())
+        return PathTable::InvalidId;
+
+    QStringList candidates(name);
+    if (QFileInfo(name).suffix().isEmpty())
+        candidates.append(name + defaultSuffix);
+
+    const QStringList directories = { m_paths->directory(from), m_paths->baseDirectory() };
+    for (const QString &directory : directories) {
+        for (const QString &candidate : candidates) {
+            const QFileInfo fileInfo(QDir(directory), candidate);
+            if (fileInfo.isFile())
+                return m_paths->intern(QDir::cleanPath(fileInfo.absoluteFilePath()));
+        }
+    }
+    return PathTable::InvalidId;
+}
+
+void DependencyGraph::addEdges(PathTable::Id id, const FileEntry &entry)
+{
+    for (PathTable::Id dependency : entry.procedures)
+        m_dependents[dependency].insert(id);
+    for (PathTable::Id dependency : entry.includes)
+        m_dependents[dependency].insert(id);
+}
+
+void DependencyGraph::removeEdges(PathTable::Id id, const FileEntry &entry)
+{
+    for (PathTable::Id dependency : entry.procedures + entry.includes) {
+        auto it = m_dependents.find(dependency);
+        if (it == m_dependents.end())
+            continue;
+        it.value().remove(id);
+        if (it.value().isEmpty())
+            m_dependents.erase(it);
+    }
+}
+
+void DependencyGraph::invalidate(const QSet<PathTable::Id> &files)
+{
+    for (PathTable::Id id : files)
+        m_expandedDefinitions.remove(id);
+}
+
+}  // namespace Internal
+}  // namespace dBaseEditor
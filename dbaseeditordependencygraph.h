@@ -0,0 +1,69 @@
+#pragma once
+
+#include "dbaseeditorpathtable.h"
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+namespace dBaseEditor {
+namespace Internal {
+
+typedef QHash<QString, QString> Definitions;
+
+/**
+ * @brief Project wide graph of SET PROCEDURE TO and #include edges.
+ *
+ * Files are scanned with the Scanner and only rescanned when their
+ * modification time changed or when they were saved in the editor. The
+ * preprocessor definitions visible in a file, its own #define entries
+ * merged over those of the files it includes, are memoized per file and
+ * dropped again when the file or one of its dependencies changes.
+ */
+class DependencyGraph
+{
+public:
+    explicit DependencyGraph(PathTable *paths);
+
+    QSet<PathTable::Id> update(const QVector<PathTable::Id> &files);
+    QSet<PathTable::Id> fileChanged(PathTable::Id id);
+
+    QVector<PathTable::Id> dependencies(PathTable::Id id) const;
+    QSet<PathTable::Id> dependents(PathTable::Id id) const;
+    QSet<PathTable::Id> affectedFiles(const QSet<PathTable::Id> &changed) const;
+
+    Definitions definitions(PathTable::Id id);
+
+private:
+    struct FileEntry
+    {
+        bool sameContents(const FileEntry &other) const
+        {
+            return procedures == other.procedures && includes == other.includes
+                    && definitions == other.definitions;
+        }
+
+        qint64 lastModified = -1;
+        QVector<PathTable::Id> procedures;
+        QVector<PathTable::Id> includes;
+        Definitions definitions;
+    };
+
+    bool rescan(PathTable::Id id, bool force = false);
+    void scanFile(PathTable::Id id, FileEntry *entry);
+    PathTable::Id resolve(PathTable::Id from, QString name, const QString &defaultSuffix);
+    void addEdges(PathTable::Id id, const FileEntry &entry);
+    void removeEdges(PathTable::Id id, const FileEntry &entry);
+    void invalidate(const QSet<PathTable::Id> &files);
+    Definitions definitions(PathTable::Id id, QHash<PathTable::Id, int> *visiting,
+                            int *cycleDepth);
+
+    PathTable *m_paths;
+    QHash<PathTable::Id, FileEntry> m_files;
+    QHash<PathTable::Id, QSet<PathTable::Id>> m_dependents;
+    QHash<PathTable::Id, Definitions> m_expandedDefinitions;
+};
+
+}  // namespace Internal
+}  // namespace dBaseEditor
@@ -0,0 +1,226 @@
+#include "dbaseeditorhighlighter.h"
+#include "dbaseeditorscanner.h"
+#include "dbaseeditortrace.h"
+
+#include <texteditor/fontsettings.h>
+#include <texteditor/texteditor.h>
+#include <texteditor/texteditorconstants.h>
+#include <texteditor/texteditorsettings.h>
+
+#include <QScrollBar>
+#include <QTextBlock>
+#include <QTextDocument>
+
+using namespace TextEditor;
+
+namespace dBaseEditor {
+namespace Internal {
+
+/**
+ * @brief Text styles indexed by dBaseEditor::Internal::Format.
+ */
+static const QVector<TextStyle> &formatCategories()
+{
+    static const QVector<TextStyle> categories = {
+        C_NUMBER,
+        C_STRING,
+        C_KEYWORD,
+        C_PREPROCESSOR,
+        C_OPERATOR,
+        C_COMMENT,
+        C_TEXT,
+        C_VISUAL_WHITESPACE
+    };
+    return categories;
+}
+
+/**
+ * Runs the scanner over \a text starting in \a state, calls \a callback for
+ * every token and returns the state at the end of the text.
+ */
+template <typename Callback>
+static int scanText(const QString &text, int state, Callback callback)
+{
+    Scanner scanner(text.constData(), text.size());
+    scanner.setState(state);
+
+    FormatToken tk;
+    while ((tk = scanner.read()).format() != Format_EndOfBlock)
+        callback(tk);
+
+    return scanner.state();
+}
+
+////////////////////////////////////////////////////////////////
+
+dBaseHighlighter::dBaseHighlighter()
+{
+    setTextFormatCategories(formatCategories());
+}
+
+void dBaseHighlighter::highlightBlock(const QString &text)
+{
+    DBASE_TRACE_SCOPE("dBaseHighlighter::highlightBlock");
+
+    int state = previousBlockState();
+    if (state < 0)
+        state = Scanner::State_Default;
+
+    setCurrentBlockState(scanText(text, state, [this](const FormatToken &tk) {
+        setFormat(tk.begin(), tk.length(), formatForCategory(tk.format()));
+    }));
+}
+
+////////////////////////////////////////////////////////////////
+
+// The block user state of a highlighted block holds the highlighter
+// generation and the scanner state at the end of the block. Generations
+// start at 1; a dirty block keeps its last end state with generation 0, so
+// a changed end state can still be detected when it is highlighted again.
+static int encodeState(int generation, int state)
+{
+    return (generation << 2) | (state + 1);
+}
+
+dBaseVisibleRegionHighlighter::dBaseVisibleRegionHighlighter(TextEditorWidget *widget)
+    : QObject(widget)
+    , m_widget(widget)
+{
+    updateFormats();
+
+    m_updateTimer.setSingleShot(true);
+    m_updateTimer.setInterval(0);
+    connect(&m_updateTimer, &QTimer::timeout,
+            this, &dBaseVisibleRegionHighlighter::updateVisibleBlocks);
+
+    connect(widget->verticalScrollBar(), &QScrollBar::valueChanged,
+            this, &dBaseVisibleRegionHighlighter::scheduleUpdate);
+    connect(widget->verticalScrollBar(), &QScrollBar::rangeChanged,
+            this, &dBaseVisibleRegionHighlighter::scheduleUpdate);
+    connect(widget->document(), &QTextDocument::contentsChange,
+            this, &dBaseVisibleRegionHighlighter::invalidate);
+    connect(TextEditorSettings::instance(), &TextEditorSettings::fontSettingsChanged,
+            this, [this] {
+        updateFormats();
+        scheduleUpdate();
+    });
+
+    scheduleUpdate();
+}
+
+void dBaseVisibleRegionHighlighter::updateFormats()
+{
+    const FontSettings &fontSettings = TextEditorSettings::fontSettings();
+    m_formats.clear();
+    for (TextStyle category : formatCategories())
+        m_formats.append(fontSettings.toTextCharFormat(category));
+
+    // Blocks highlighted with the old formats are redone when shown again
+    m_generation = m_generation % 0xfffff + 1;
+}
+
+void dBaseVisibleRegionHighlighter::scheduleUpdate()
+{
+    m_updateTimer.start();
+}
+
+void dBaseVisibleRegionHighlighter::updateVisibleBlocks()
+{
+    DBASE_TRACE_SCOPE("dBaseVisibleRegionHighlighter::updateVisibleBlocks");
+
+    QTextBlock block = m_widget->cursorForPosition(QPoint(0, 0)).block();
+    const QTextBlock last
+            = m_widget->cursorForPosition(QPoint(0, m_widget->viewport()->height())).block();
+
+    m_updating = true;
+    for (; block.isValid(); block = block.next()) {
+        if (!isHighlighted(block)) {
+            const QTextBlock previous = block.previous();
+            const int state = previous.isValid() && isHighlighted(previous)
+                    ? endState(previous) : int(Scanner::State_Default);
+            highlight(block, state);
+        }
+        if (block == last)
+            break;
+    }
+    m_updating = false;
+}
+
+void dBaseVisibleRegionHighlighter::invalidate(int position, int charsRemoved, int charsAdded)
+{
+    Q_UNUSED(charsRemoved)
+    if (m_updating)
+        return;
+
+    QTextDocument *document = m_widget->document();
+    QTextBlock block = document->findBlock(position);
+    const QTextBlock last = document->findBlock(position + charsAdded);
+    for (; block.isValid(); block = block.next()) {
+        markDirty(block);
+        if (block == last)
+            break;
+    }
+
+    scheduleUpdate();
+}
+
+bool dBaseVisibleRegionHighlighter::isHighlighted(const QTextBlock &block) const
+{
+    const int userState = block.userState();
+    return userState >= 0 && (userState >> 2) == m_generation;
+}
+
+/**
+ * Returns whether \a block was highlighted before, possibly with an older
+ * generation or before it was edited.
+ */
+bool dBaseVisibleRegionHighlighter::hasEndState(const QTextBlock &block)
+{
+    return block.userState() > 0;
+}
+
+/**
+ * Returns the scanner state at the end of \a block when it was last
+ * highlighted.
+ */
+int dBaseVisibleRegionHighlighter::endState(const QTextBlock &block)
+{
+    return (block.userState() & 3) - 1;
+}
+
+void dBaseVisibleRegionHighlighter::markDirty(QTextBlock block)
+{
+    if (block.userState() > 0)
+        block.setUserState(block.userState() & 3);
+}
+
+void dBaseVisibleRegionHighlighter::highlight(QTextBlock block, int state)
+{
+    QVector<QTextLayout::FormatRange> ranges;
+    const int newState = scanText(block.text(), state, [this, &ranges](const FormatToken &tk) {
+        if (tk.format() == Format_Whitespace)
+            return;
+        QTextLayout::FormatRange range;
+        range.start = tk.begin();
+        range.length = tk.length();
+        range.format = m_formats.at(tk.format());
+        ranges.append(range);
+    });
+
+    // An opened or closed block comment changes the next block as well. A
+    // block highlighted for the first time was taken as ending in the default
+    // state when the next block was highlighted.
+    const int previousEndState = hasEndState(block) ? endState(block)
+                                                    : int(Scanner::State_Default);
+    const bool stateChanged = previousEndState != newState;
+
+    block.layout()->setFormats(ranges);
+    block.setUserState(encodeState(m_generation, newState));
+    m_widget->document()->markContentsDirty(block.position(), block.length());
+
+    if (stateChanged && block.next().isValid())
+        markDirty(block.next());
+}
+
+}  // namespace Internal
+}  // namespace dBaseEditor
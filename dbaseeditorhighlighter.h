@@ -0,0 +1,58 @@
+#pragma once
+
+#include "dbaseformattoken.h"
+
+#include <texteditor/syntaxhighlighter.h>
+
+#include <QTextBlock>
+#include <QTextLayout>
+#include <QTimer>
+
+namespace TextEditor { class TextEditorWidget; }
+
+namespace dBaseEditor {
+namespace Internal {
+
+class dBaseHighlighter : public TextEditor::SyntaxHighlighter
+{
+public:
+    dBaseHighlighter();
+
+protected:
+    void highlightBlock(const QString &text) override;
+};
+
+/**
+ * @brief Highlights only the blocks visible in \a widget.
+ *
+ * Used in large-file mode instead of a document wide highlighter. Blocks
+ * are highlighted when they scroll into view; an open block comment is
+ * carried over only from blocks that have been highlighted before.
+ */
+class dBaseVisibleRegionHighlighter : public QObject
+{
+public:
+    explicit dBaseVisibleRegionHighlighter(TextEditor::TextEditorWidget *widget);
+
+    static int endState(const QTextBlock &block);
+
+private:
+    void updateFormats();
+    void scheduleUpdate();
+    void updateVisibleBlocks();
+    void invalidate(int position, int charsRemoved, int charsAdded);
+
+    bool isHighlighted(const QTextBlock &block) const;
+    static bool hasEndState(const QTextBlock &block);
+    static void markDirty(QTextBlock block);
+    void highlight(QTextBlock block, int state);
+
+    TextEditor::TextEditorWidget *m_widget;
+    QVector<QTextCharFormat> m_formats;
+    QTimer m_updateTimer;
+    int m_generation = 0;
+    bool m_updating = false;
+};
+
+}  // namespace Internal
+}  // namespace dBaseEditor
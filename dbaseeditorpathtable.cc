@@ -0,0 +1,150 @@
+#include "dbaseeditorpathtable.h"
+
+#include <utils/fileutils.h>
+#include <utils/qtcassert.h>
+
+#include <QDir>
+
+using namespace Utils;
+
+namespace dBaseEditor {
+namespace Internal {
+
+static QString relativeDirectory(const QString &base, const QString &directory)
+{
+    if (base.isEmpty())
+        return directory;
+
+    const FileName directoryPath = FileName::fromString(directory);
+    const FileName basePath = FileName::fromString(base);
+    if (directoryPath == basePath)
+        return QString();
+    if (directoryPath.isChildOf(basePath))
+        return directoryPath.relativeChildPath(basePath).toString();
+
+    // The directory is not part of the project.
+    QString relativePath = QDir(base).relativeFilePath(directory);
+    if (relativePath.endsWith('/'))
+        relativePath.chop(1);
+    return relativePath;
+}
+
+void PathTable::setBaseDirectory(const QString &baseDirectory)
+{
+    if (baseDirectory == m_baseDirectory)
+        return;
+
+    m_baseDirectory = baseDirectory;
+    for (Directory &directory : m_directories)
+        directory.relativePath = relativeDirectory(m_baseDirectory, directory.path);
+}
+
+/**
+ * Returns the id of \a absolutePath, adding it to the table if needed. The
+ * path is expected to be clean and to use '/' as separator.
+ */
+PathTable::Id PathTable::intern(const QString &absolutePath)
+{
+    auto it = m_entryIds.constFind(absolutePath);
+    if (it != m_entryIds.constEnd())
+        return it.value();
+
+    // Keep the root directory as "/" rather than an empty string
+    const int start = fileNameStart(absolutePath);
+    const QString directory = absolutePath.left(start > 1 ? start - 1 : start);
+
+    const Id id = m_entries.size();
+    m_entries.append({ internDirectory(directory), absolutePath });
+    m_entryIds.insert(absolutePath, id);
+    return id;
+}
+
+PathTable::Id PathTable::find(const QString &absolutePath) const
+{
+    return m_entryIds.value(absolutePath, InvalidId);
+}
+
+const QString &PathTable::path(Id id) const
+{
+    static const QString empty;
+    QTC_ASSERT(id >= 0 && id < m_entries.size(), return empty);
+    return m_entries.at(id).path;
+}
+
+QString PathTable::fileName(Id id) const
+{
+    QTC_ASSERT(id >= 0 && id < m_entries.size(), return QString());
+    const QString &path = m_entries.at(id).path;
+    return path.mid(fileNameStart(path));
+}
+
+QString PathTable::directory(Id id) const
+{
+    QTC_ASSERT(id >= 0 && id < m_entries.size(), return QString());
+    return m_directories.at(m_entries.at(id).directory).path;
+}
+
+/**
+ * Returns the path of \a id relative to the base directory.
+ */
+QString PathTable::relativePath(Id id) const
+{
+    QTC_ASSERT(id >= 0 && id < m_entries.size(), return QString());
+    const Entry &entry = m_entries.at(id);
+    const QString &directory = m_directories.at(entry.directory).relativePath;
+    const QString fileName = entry.path.mid(fileNameStart(entry.path));
+    if (directory.isEmpty())
+        return fileName;
+    return directory + '/' + fileName;
+}
+
+/**
+ * Estimates the heap memory held by the table: the path strings, the entry
+ * arrays and the nodes of the lookup hashes.
+ */
+qint64 PathTable::memoryUsage() const
+{
+    qint64 result = m_entries.capacity() * qint64(sizeof(Entry))
+            + m_directories.capacity() * qint64(sizeof(Directory));
+    for (const Entry &entry : m_entries)
+        result += stringMemoryUsage(entry.path);
+    for (const Directory &directory : m_directories)
+        result += stringMemoryUsage(directory.path) + stringMemoryUsage(directory.relativePath);
+
+    // Hash keys share the buffers counted above
+    const qint64 nodeSize = sizeof(void *) + sizeof(uint) + sizeof(QString) + sizeof(int);
+    result += (m_entryIds.size() + m_directoryIds.size()) * nodeSize
+            + (m_entryIds.capacity() + m_directoryIds.capacity()) * qint64(sizeof(void *));
+    return result;
+}
+
+/**
+ * Returns the size of the buffer allocated for \a string, or 0 for the
+ * shared empty string.
+ */
+qint64 PathTable::stringMemoryUsage(const QString &string)
+{
+    if (string.isEmpty())
+        return 0;
+    return qint64(sizeof(QArrayData)) + (string.capacity() + 1) * qint64(sizeof(QChar));
+}
+
+int PathTable::internDirectory(const QString &path)
+{
+    auto it = m_directoryIds.constFind(path);
+    if (it != m_directoryIds.constEnd())
+        return it.value();
+
+    const int id = m_directories.size();
+    m_directories.append({ path, relativeDirectory(m_baseDirectory, path) });
+    m_directoryIds.insert(path, id);
+    return id;
+}
+
+int PathTable::fileNameStart(const QString &absolutePath)
+{
+    return absolutePath.lastIndexOf('/') + 1;
+}
+
+}  // namespace Internal
+}  // namespace dBaseEditor
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+namespace dBaseEditor {
+namespace Internal {
+
+/**
+ * @brief Interned absolute file paths of a project.
+ *
+ * Every path is stored once and handed out as an implicitly shared QString,
+ * so the file nodes of the project tree hold the same buffer. Directories
+ * are stored once as well, together with their path relative to the base
+ * directory, so display names are built on demand instead of being kept per
+ * file.
+ *
+ * Ids stay valid for the lifetime of the table and entries are never
+ * removed: paths of removed or renamed files and of includes that went away
+ * stay until the owner replaces the table, see dBaseProject::parseProject().
+ */
+class PathTable
+{
+public:
+    typedef int Id;
+    enum { InvalidId = -1 };
+
+    void setBaseDirectory(const QString &baseDirectory);
+    QString baseDirectory() const { return m_baseDirectory; }
+
+    Id intern(const QString &absolutePath);
+    Id find(const QString &absolutePath) const;
+
+    const QString &path(Id id) const;
+    QString fileName(Id id) const;
+    QString directory(Id id) const;
+    QString relativePath(Id id) const;
+
+    int size() const { return m_entries.size(); }
+    qint64 memoryUsage() const;
+
+    static qint64 stringMemoryUsage(const QString &string);
+
+private:
+    struct Directory
+    {
+        QString path;
+        QString relativePath;
+    };
+
+    struct Entry
+    {
+        int directory;
+        QString path;
+    };
+
+    int internDirectory(const QString &path);
+    static int fileNameStart(const QString &absolutePath);
+
+    QString m_baseDirectory;
+    QVector<Directory> m_directories;
+    QHash<QString, int> m_directoryIds;
+    QVector<Entry> m_entries;
+    QHash<QString, Id> m_entryIds;
+};
+
+}  // namespace Internal
+}  // namespace dBaseEditor
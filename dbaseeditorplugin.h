@@ -16,6 +16,11 @@ public:
     
     bool initialize(const QStringList &arguments, QString *errorMessage) override;
     void extensionsInitialized() override;
+    ShutdownFlag aboutToShutdown() override;
+
+#ifdef WITH_TESTS
+    QList<QObject *> createTestObjects() const override;
+#endif
 };
 
 }  // namespace: Internal
@@ -0,0 +1,435 @@
+#include "dbaseeditorprofiler.h"
+#include "dbaseeditorconstants.h"
+#include "dbaseeditortrace.h"
+
+#include <coreplugin/editormanager/editormanager.h>
+
+#include <projectexplorer/project.h>
+#include <projectexplorer/runnables.h>
+
+#include <texteditor/textmark.h>
+
+#include <utils/qtcassert.h>
+#include <utils/theme/theme.h>
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QHeaderView>
+#include <QPainter>
+#include <QPixmap>
+#include <QTemporaryFile>
+#include <QTextStream>
+#include <QTreeWidget>
+
+using namespace ProjectExplorer;
+using namespace Utils;
+
+namespace dBaseEditor {
+namespace Internal {
+
+enum ProfileColumn {
+    FileColumn,
+    LineColumn,
+    ProcedureColumn,
+    HitsColumn,
+    TimeColumn,
+    ColumnCount
+};
+
+static QString formatNsecs(quint64 nsecs)
+{
+    return QString::number(double(nsecs) / 1000000.0, 'f', 3);
+}
+
+////////////////////////////////////////////////////////////////
+
+bool ProfileData::load(const QString &traceFile, const QString &baseDirectory,
+                       QString *errorMessage)
+{
+    DBASE_TRACE_SCOPE("ProfileData::load");
+    m_lines.clear();
+
+    QFile file(traceFile);
+    if (!file.open(QFile::ReadOnly | QFile::Text)) {
+        if (errorMessage)
+            *errorMessage = file.errorString();
+        return false;
+    }
+
+    const QDir baseDir(baseDirectory);
+    QHash<QPair<QString, int>, int> index;
+    QTextStream stream(&file);
+
+    forever {
+        const QString line = stream.readLine();
+        if (line.isNull())
+            break;
+        if (line.isEmpty() || line.startsWith('#'))
+            continue;
+
+        const QStringList fields = line.split('\t');
+        if (fields.size() != 5)
+            continue;
+
+        bool ok = false;
+        const int lineNumber = fields.at(1).toInt(&ok);
+        if (!ok || lineNumber <= 0)
+            continue;
+
+        ProfileEntry entry;
+        entry.fileName = QDir::cleanPath(baseDir.absoluteFilePath(fields.at(0)));
+        entry.line = lineNumber;
+        entry.procedure = fields.at(2);
+        entry.hits = fields.at(3).toULongLong();
+        entry.nsecs = fields.at(4).toULongLong();
+
+        const QPair<QString, int> key(entry.fileName, entry.line);
+        auto it = index.constFind(key);
+        if (it == index.constEnd()) {
+            index.insert(key, m_lines.size());
+            m_lines.append(entry);
+        } else {
+            ProfileEntry &existing = m_lines[it.value()];
+            existing.hits += entry.hits;
+            existing.nsecs += entry.nsecs;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Sums the line records into one entry per procedure. The reported line is
+ * the first line of the procedure that was executed, the time is the sum of
+ * its lines. The trace has no call counts, so the hits of a procedure are
+ * those of its most executed line; for procedures with loops this is more
+ * than the number of calls.
+ */
+QVector<ProfileEntry> ProfileData::procedures() const
+{
+    QVector<ProfileEntry> result;
+    QHash<QPair<QString, QString>, int> index;
+
+    for (const ProfileEntry &line : m_lines) {
+        if (line.procedure.isEmpty())
+            continue;
+
+        const QPair<QString, QString> key(line.fileName, line.procedure);
+        auto it = index.constFind(key);
+        if (it == index.constEnd()) {
+            index.insert(key, result.size());
+            result.append(line);
+        } else {
+            ProfileEntry &procedure = result[it.value()];
+            procedure.line = qMin(procedure.line, line.line);
+            procedure.hits = qMax(procedure.hits, line.hits);
+            procedure.nsecs += line.nsecs;
+        }
+    }
+
+    return result;
+}
+
+quint64 ProfileData::maxLineNsecs() const
+{
+    quint64 result = 0;
+    for (const ProfileEntry &line : m_lines)
+        result = qMax(result, line.nsecs);
+    return result;
+}
+
+////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Heat-map mark: the icon goes from green (cold) to red (hot)
+ *        relative to the most expensive line of the run.
+ */
+class ProfileMark : public TextEditor::TextMark
+{
+public:
+    ProfileMark(const ProfileEntry &entry, double heat)
+        : TextMark(entry.fileName, entry.line, Constants::C_DBASE_PROFILE_MARK_CATEGORY)
+    {
+        QPixmap pixmap(12, 12);
+        pixmap.fill(Qt::transparent);
+        QPainter painter(&pixmap);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(QColor::fromHsvF((1.0 - heat) / 3.0, 0.9, 0.9));
+        painter.drawEllipse(pixmap.rect().adjusted(1, 1, -1, -1));
+        painter.end();
+        setIcon(QIcon(pixmap));
+
+        if (heat >= 0.5) {
+            setColor(Theme::ProjectExplorer_TaskError_TextMarkColor);
+            setPriority(HighPriority);
+        } else if (heat >= 0.1) {
+            setColor(Theme::ProjectExplorer_TaskWarn_TextMarkColor);
+            setPriority(NormalPriority);
+        } else {
+            setPriority(LowPriority);
+        }
+
+        setToolTip(QCoreApplication::translate("dBaseEditor::Internal::ProfileMark",
+                                               "%1 hits, %2 ms (%3%)")
+                   .arg(entry.hits)
+                   .arg(formatNsecs(entry.nsecs))
+                   .arg(qRound(heat * 100)));
+    }
+};
+
+/**
+ * @brief Tree item that sorts the numeric columns by value.
+ */
+class ProfileItem : public QTreeWidgetItem
+{
+public:
+    explicit ProfileItem(const ProfileEntry &entry)
+        : m_entry(entry)
+    {
+        setText(FileColumn, QFileInfo(entry.fileName).fileName());
+        setToolTip(FileColumn, entry.fileName);
+        setText(LineColumn, QString::number(entry.line));
+        setText(ProcedureColumn, entry.procedure);
+        setText(HitsColumn, QString::number(entry.hits));
+        setText(TimeColumn, formatNsecs(entry.nsecs));
+        for (int column = LineColumn; column < ColumnCount; ++column) {
+            if (column != ProcedureColumn)
+                setTextAlignment(column, Qt::AlignRight | Qt::AlignVCenter);
+        }
+    }
+
+    const ProfileEntry &entry() const { return m_entry; }
+
+    bool operator<(const QTreeWidgetItem &other) const override
+    {
+        const ProfileEntry &o = static_cast<const ProfileItem &>(other).m_entry;
+        switch (treeWidget()->sortColumn()) {
+        case LineColumn:
+            return m_entry.line < o.line;
+        case HitsColumn:
+            return m_entry.hits < o.hits;
+        case TimeColumn:
+            return m_entry.nsecs < o.nsecs;
+        default:
+            return QTreeWidgetItem::operator<(other);
+        }
+    }
+
+private:
+    ProfileEntry m_entry;
+};
+
+////////////////////////////////////////////////////////////////
+
+dBaseProfileRunner::dBaseProfileRunner(RunControl *runControl)
+    : SimpleTargetRunner(runControl)
+{
+    connect(this, &RunWorker::stopped, this, &dBaseProfileRunner::loadResults);
+}
+
+void dBaseProfileRunner::start()
+{
+    QTemporaryFile traceFile(QDir::temp().filePath("dbase-profile-XXXXXX.trace"));
+    traceFile.setAutoRemove(false);
+    if (traceFile.open()) {
+        m_traceFile = traceFile.fileName();
+        traceFile.close();
+    } else {
+        appendMessage(tr("Cannot create profile trace file: %1")
+                      .arg(traceFile.errorString()), ErrorMessageFormat);
+    }
+
+    StandardRunnable r = runnable().as<StandardRunnable>();
+    if (!m_traceFile.isEmpty())
+        r.environment.set(Constants::C_DBASE_PROFILE_FILE_ENV, m_traceFile);
+    m_workingDirectory = r.workingDirectory;
+    if (m_workingDirectory.isEmpty() && runControl()->project())
+        m_workingDirectory = runControl()->project()->projectDirectory().toString();
+    setRunnable(r);
+
+    SimpleTargetRunner::start();
+}
+
+void dBaseProfileRunner::loadResults()
+{
+    if (m_traceFile.isEmpty())
+        return;
+
+    ProfileData data;
+    QString errorMessage;
+    if (!data.load(m_traceFile, m_workingDirectory, &errorMessage)) {
+        appendMessage(tr("Cannot read profile trace file %1: %2")
+                      .arg(m_traceFile, errorMessage), ErrorMessageFormat);
+    } else if (data.isEmpty()) {
+        appendMessage(tr("The runner did not write any profile data."), ErrorMessageFormat);
+    } else {
+        dBaseProfileOutputPane::instance()->setProfileData(data);
+    }
+
+    QFile::remove(m_traceFile);
+    m_traceFile.clear();
+}
+
+////////////////////////////////////////////////////////////////
+
+static dBaseProfileOutputPane *m_paneInstance = 0;
+
+dBaseProfileOutputPane::dBaseProfileOutputPane()
+    : m_view(new QTreeWidget)
+{
+    m_paneInstance = this;
+
+    m_view->setColumnCount(ColumnCount);
+    m_view->setHeaderLabels({ tr("File"), tr("Line"), tr("Procedure"),
+                              tr("Hits"), tr("Time (ms)") });
+    m_view->setRootIsDecorated(true);
+    m_view->setUniformRowHeights(true);
+    m_view->setSortingEnabled(true);
+    m_view->sortByColumn(TimeColumn, Qt::DescendingOrder);
+    m_view->header()->setStretchLastSection(false);
+    m_view->header()->setSectionResizeMode(FileColumn, QHeaderView::Stretch);
+
+    connect(m_view, &QTreeWidget::itemActivated,
+            this, &dBaseProfileOutputPane::openEntry);
+}
+
+dBaseProfileOutputPane::~dBaseProfileOutputPane()
+{
+    clearMarks();
+    delete m_view;
+    m_paneInstance = 0;
+}
+
+dBaseProfileOutputPane *dBaseProfileOutputPane::instance()
+{
+    return m_paneInstance;
+}
+
+/**
+ * Replaces the previous results: procedures are the top level items of the
+ * hotspot table with their lines as children, every line gets a heat mark.
+ */
+void dBaseProfileOutputPane::setProfileData(const ProfileData &data)
+{
+    DBASE_TRACE_SCOPE("dBaseProfileOutputPane::setProfileData");
+    clearContents();
+
+    // Inserting into a sorted view sorts on every item
+    m_view->setSortingEnabled(false);
+
+    const quint64 maxNsecs = qMax<quint64>(data.maxLineNsecs(), 1);
+    for (const ProfileEntry &line : data.lines())
+        m_marks.append(new ProfileMark(line, double(line.nsecs) / maxNsecs));
+
+    QHash<QPair<QString, QString>, QTreeWidgetItem *> procedureItems;
+    for (const ProfileEntry &procedure : data.procedures()) {
+        auto item = new ProfileItem(procedure);
+        procedureItems.insert(qMakePair(procedure.fileName, procedure.procedure), item);
+        m_view->addTopLevelItem(item);
+    }
+
+    for (const ProfileEntry &line : data.lines()) {
+        QTreeWidgetItem *parent
+                = procedureItems.value(qMakePair(line.fileName, line.procedure));
+        if (parent)
+            parent->addChild(new ProfileItem(line));
+        else
+            m_view->addTopLevelItem(new ProfileItem(line));
+    }
+
+    m_view->setSortingEnabled(true);
+    m_view->sortByColumn(TimeColumn, Qt::DescendingOrder);
+
+    popup(NoModeSwitch);
+}
+
+QWidget *dBaseProfileOutputPane::outputWidget(QWidget *parent)
+{
+    m_view->setParent(parent);
+    return m_view;
+}
+
+QList<QWidget *> dBaseProfileOutputPane::toolBarWidgets() const
+{
+    return {};
+}
+
+QString dBaseProfileOutputPane::displayName() const
+{
+    return tr("dBase Profile");
+}
+
+int dBaseProfileOutputPane::priorityInStatusBar() const
+{
+    return -1;
+}
+
+void dBaseProfileOutputPane::clearContents()
+{
+    clearMarks();
+    m_view->clear();
+}
+
+void dBaseProfileOutputPane::visibilityChanged(bool visible)
+{
+    Q_UNUSED(visible)
+}
+
+void dBaseProfileOutputPane::setFocus()
+{
+    m_view->setFocus();
+}
+
+bool dBaseProfileOutputPane::hasFocus() const
+{
+    return m_view->window()->focusWidget() == m_view;
+}
+
+bool dBaseProfileOutputPane::canFocus() const
+{
+    return true;
+}
+
+bool dBaseProfileOutputPane::canNavigate() const
+{
+    return false;
+}
+
+bool dBaseProfileOutputPane::canNext() const
+{
+    return false;
+}
+
+bool dBaseProfileOutputPane::canPrevious() const
+{
+    return false;
+}
+
+void dBaseProfileOutputPane::goToNext()
+{
+}
+
+void dBaseProfileOutputPane::goToPrev()
+{
+}
+
+void dBaseProfileOutputPane::clearMarks()
+{
+    qDeleteAll(m_marks);
+    m_marks.clear();
+}
+
+void dBaseProfileOutputPane::openEntry(QTreeWidgetItem *item)
+{
+    auto profileItem = static_cast<ProfileItem *>(item);
+    QTC_ASSERT(profileItem, return);
+    Core::EditorManager::openEditorAt(profileItem->entry().fileName,
+                                      profileItem->entry().line);
+}
+
+}  // namespace Internal
+}  // namespace dBaseEditor
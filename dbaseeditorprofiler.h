@@ -0,0 +1,118 @@
+#pragma once
+
+#include <coreplugin/ioutputpane.h>
+#include <projectexplorer/runconfiguration.h>
+
+#include <QString>
+#include <QVector>
+
+QT_BEGIN_NAMESPACE
+class QTreeWidget;
+class QTreeWidgetItem;
+QT_END_NAMESPACE
+
+namespace dBaseEditor {
+namespace Internal {
+
+class ProfileMark;
+
+/**
+ * @brief One row of profiling results: a source line, or a whole procedure
+ *        summed by ProfileData::procedures(), in which case \c line is the
+ *        first executed line of the procedure.
+ */
+struct ProfileEntry
+{
+    QString fileName;
+    int line = 0;
+    QString procedure;
+    quint64 hits = 0;
+    quint64 nsecs = 0;
+};
+
+/**
+ * @brief Per-line and per-procedure counters read from a profile trace file.
+ *
+ * The runner (or any local stand-in runtime) keeps a hit counter and a
+ * cumulative time per executed line and writes them once when the script
+ * exits, one record per line:
+ *
+ *     <file> TAB <line> TAB <procedure> TAB <hits> TAB <nanoseconds>
+ *
+ * Lines starting with '#' are ignored. Records for the same file and line
+ * are summed, so a sampling runtime may simply append its samples.
+ */
+class ProfileData
+{
+public:
+    bool load(const QString &traceFile, const QString &baseDirectory,
+              QString *errorMessage = 0);
+
+    bool isEmpty() const { return m_lines.isEmpty(); }
+    const QVector<ProfileEntry> &lines() const { return m_lines; }
+    QVector<ProfileEntry> procedures() const;
+    quint64 maxLineNsecs() const;
+
+private:
+    QVector<ProfileEntry> m_lines;
+};
+
+/**
+ * @brief Runs a dBase script in the profile run mode.
+ *
+ * The trace file location is passed to the runner in the
+ * DBASE_PROFILE_FILE environment variable; results are handed to the
+ * hotspot pane once the process has stopped.
+ */
+class dBaseProfileRunner : public ProjectExplorer::SimpleTargetRunner
+{
+    Q_OBJECT
+
+public:
+    explicit dBaseProfileRunner(ProjectExplorer::RunControl *runControl);
+
+private:
+    void start() override;
+    void loadResults();
+
+    QString m_traceFile;
+    QString m_workingDirectory;
+};
+
+class dBaseProfileOutputPane : public Core::IOutputPane
+{
+    Q_OBJECT
+
+public:
+    dBaseProfileOutputPane();
+    ~dBaseProfileOutputPane() override;
+
+    static dBaseProfileOutputPane *instance();
+
+    void setProfileData(const ProfileData &data);
+
+    QWidget *outputWidget(QWidget *parent) override;
+    QList<QWidget *> toolBarWidgets() const override;
+    QString displayName() const override;
+    int priorityInStatusBar() const override;
+    void clearContents() override;
+    void visibilityChanged(bool visible) override;
+    void setFocus() override;
+    bool hasFocus() const override;
+    bool canFocus() const override;
+    bool canNavigate() const override;
+    bool canNext() const override;
+    bool canPrevious() const override;
+    void goToNext() override;
+    void goToPrev() override;
+
+private:
+    void clearMarks();
+    void openEntry(QTreeWidgetItem *item);
+
+    QTreeWidget *m_view;
+    QList<ProfileMark *> m_marks;
+};
+
+}  // namespace Internal
+}  // namespace dBaseEditor
@@ -0,0 +1,382 @@
+#include "dbaseeditorproject.h"
+#include "dbaseeditorconstants.h"
+#include "dbaseeditortrace.h"
+
+#include <coreplugin/icore.h>
+#include <coreplugin/documentmanager.h>
+#include <coreplugin/editormanager/editormanager.h>
+#include <coreplugin/idocument.h>
+
+#include <projectexplorer/kitmanager.h>
+#include <projectexplorer/projectexplorerconstants.h>
+#include <projectexplorer/target.h>
+
+#include <utils/fileutils.h>
+
+#include <QDir>
+#include <QFileInfo>
+#include <QProcessEnvironment>
+#include <QRegExp>
+#include <QSet>
+#include <QTextStream>
+
+#include <algorithm>
+#include <functional>
+
+using namespace Core;
+using namespace ProjectExplorer;
+using namespace Utils;
+
+namespace dBaseEditor {
+namespace Internal {
+
+const char dBaseProjectId[] = "dBaseProject";
+const char dBaseProjectContext[] = "dBaseProjectContext";
+const int StalePathAllowance = 1024;
+
+dBaseProject::dBaseProject(const FileName &fileName) :
+    Project(Constants::C_DBASE_MIMETYPE, fileName, [this]() { refresh(); }),
+    m_paths(new PathTable),
+    m_dependencies(m_paths.data())
+{
+    setId(dBaseProjectId);
+    setProjectContext(Context(dBaseProjectContext));
+    setProjectLanguages(Context(ProjectExplorer::Constants::CXX_LANGUAGE_ID)); // hier
+    setDisplayName(fileName.toFileInfo().completeBaseName());
+
+    connect(EditorManager::instance(), &EditorManager::saved,
+            this, [this](IDocument *document) {
+        documentSaved(document->filePath().toString());
+    });
+}
+
+
+static QStringList readLines(const QString &absoluteFileName)
+{
+    QStringList lines;
+
+    QFile file(absoluteFileName);
+    if (file.open(QFile::ReadOnly)) {
+        QTextStream stream(&file);
+
+        forever {
+            QString line = stream.readLine();
+            if (line.isNull())
+                break;
+
+            lines.append(line);
+        }
+    }
+
+    return lines;
+}
+
+bool dBaseProject::saveRawFileList(const QStringList &rawFileList)
+{
+    bool result = saveRawList(rawFileList, projectFilePath().toString());
+//    refresh(dBaseProject::Files);
+    return result;
+}
+
+bool dBaseProject::saveRawList(const QStringList &rawList, const QString &fileName)
+{
+    DBASE_TRACE_SCOPE("dBaseProject::saveRawList");
+    FileChangeBlocker changeGuarg(fileName);
+    // Make sure we can open the file for writing
+    FileSaver saver(fileName, QIODevice::Text);
+    if (!saver.hasError()) {
+        QTextStream stream(saver.file());
+        foreach (const QString &filePath, rawList)
+            stream << filePath << '\n';
+        saver.setResult(&stream);
+    }
+    bool result = saver.finalize(ICore::mainWindow());
+    return result;
+}
+
+bool dBaseProject::addFiles(const QStringList &filePaths)
+{
+    DBASE_TRACE_SCOPE("dBaseProject::addFiles");
+    QStringList newList = m_rawFileList;
+
+    QDir baseDir(projectDirectory().toString());
+    foreach (const QString &filePath, filePaths)
+        newList.append(baseDir.relativeFilePath(filePath));
+
+    QSet<QString> toAdd;
+
+    foreach (const QString &filePath, filePaths) {
+        QString directory = QFileInfo(filePath).absolutePath();
+        if (!toAdd.contains(directory))
+            toAdd << directory;
+    }
+
+    bool result = saveRawList(newList, projectFilePath().toString());
+    refresh();
+
+    return result;
+}
+
+bool dBaseProject::removeFiles(const QStringList &filePaths)
+{
+    DBASE_TRACE_SCOPE("dBaseProject::removeFiles");
+    QStringList newList = m_rawFileList;
+
+    QList<int> indexes;
+    foreach (const QString &filePath, filePaths) {
+        const int index = m_rawListEntries.value(m_paths->find(filePath), -1);
+        if (index != -1)
+            indexes.append(index);
+    }
+
+    // Remove from the back so the remaining indexes stay valid
+    std::sort(indexes.begin(), indexes.end(), std::greater<int>());
+    indexes.erase(std::unique(indexes.begin(), indexes.end()), indexes.end());
+    foreach (int index, indexes)
+        newList.removeAt(index);
+
+    return saveRawFileList(newList);
+}
+
+bool dBaseProject::setFiles(const QStringList &filePaths)
+{
+    DBASE_TRACE_SCOPE("dBaseProject::setFiles");
+    QStringList newList;
+    QDir baseDir(projectFilePath().toString());
+    foreach (const QString &filePath, filePaths)
+        newList.append(baseDir.relativeFilePath(filePath));
+
+    return saveRawFileList(newList);
+}
+
+bool dBaseProject::renameFile(const QString &filePath, const QString &newFilePath)
+{
+    DBASE_TRACE_SCOPE("dBaseProject::renameFile");
+    QStringList newList = m_rawFileList;
+
+    const int index = m_rawListEntries.value(m_paths->find(filePath), -1);
+    if (index != -1) {
+        QDir baseDir(projectFilePath().toString());
+        newList.replace(index, baseDir.relativeFilePath(newFilePath));
+    }
+
+    return saveRawFileList(newList);
+}
+
+void dBaseProject::parseProject()
+{
+    DBASE_TRACE_SCOPE("dBaseProject::parseProject");
+
+    // Paths of removed or renamed files and of includes that went away are
+    // never dropped from the table; start over with a new one once they make
+    // up most of it. The current file nodes keep the old table alive until
+    // they are replaced.
+    if (m_paths->size() > 2 * m_files.size() + StalePathAllowance) {
+        m_paths.reset(new PathTable);
+        m_dependencies = DependencyGraph(m_paths.data());
+    }
+
+    m_rawListEntries.clear();
+    m_paths->setBaseDirectory(projectDirectory().toString());
+    m_rawFileList = readLines(projectFilePath().toString());
+    m_rawFileList << projectFilePath().fileName();
+    m_files = processEntries(m_rawFileList, &m_rawListEntries);
+    m_dependenciesValid = false;
+}
+
+/**
+ * @brief Provides displayName relative to project node
+ *
+ * The display name is computed from the project's path table when asked
+ * for instead of being stored per node; the file path shares its buffer
+ * with the table.
+ */
+class dBaseFileNode : public FileNode
+{
+public:
+    dBaseFileNode(const QSharedPointer<const PathTable> &paths, PathTable::Id id,
+                   FileType fileType = FileType::Source)
+        : FileNode(FileName::fromString(paths->path(id)), fileType, false)
+        , m_paths(paths)
+        , m_id(id)
+    {}
+
+    QString displayName() const override { return m_paths->relativePath(m_id); }
+private:
+    QSharedPointer<const PathTable> m_paths;
+    PathTable::Id m_id;
+};
+
+void dBaseProject::refresh()
+{
+    DBASE_TRACE_SCOPE("dBaseProject::refresh");
+    emitParsingStarted();
+    parseProject();
+
+    auto newRoot = new dBaseProjectNode(this);
+    {
+        DBASE_TRACE_SCOPE("dBaseProject::buildTree");
+        for (PathTable::Id id : m_files) {
+            FileType fileType = m_paths->path(id).endsWith(".dbgprj") ? FileType::Project : FileType::Source;
+            newRoot->addNestedNode(new dBaseFileNode(m_paths, id, fileType));
+        }
+    }
+    {
+        DBASE_TRACE_SCOPE("dBaseProject::setRootProjectNode");
+        setRootProjectNode(newRoot);
+    }
+
+    emitParsingFinished(true);
+}
+
+/**
+ * Returns the files that have to be re-analyzed after \a filePath changed:
+ * the file itself and every file that depends on it through SET PROCEDURE TO
+ * or #include. This is a query only, the memoized definitions are kept.
+ */
+QStringList dBaseProject::filesAffectedBy(const QString &filePath)
+{
+    DBASE_TRACE_SCOPE("dBaseProject::filesAffectedBy");
+    updateDependencies();
+
+    const PathTable::Id id = m_paths->find(filePath);
+    if (id == PathTable::InvalidId)
+        return QStringList(filePath);
+
+    QStringList result;
+    for (PathTable::Id affected : m_dependencies.affectedFiles({ id }))
+        result.append(m_paths->path(affected));
+    return result;
+}
+
+/**
+ * Returns the #define entries visible in \a filePath, including those of
+ * the files it includes. The result is cached until one of them changes.
+ */
+Definitions dBaseProject::preprocessorDefinitions(const QString &filePath)
+{
+    updateDependencies();
+
+    const PathTable::Id id = m_paths->find(filePath);
+    if (id == PathTable::InvalidId)
+        return Definitions();
+    return m_dependencies.definitions(id);
+}
+
+// The graph is built on first use, not on every refresh, to keep project
+// loading free of reading every source file.
+void dBaseProject::updateDependencies()
+{
+    if (m_dependenciesValid)
+        return;
+    m_dependencies.update(m_files);
+    m_dependenciesValid = true;
+}
+
+void dBaseProject::documentSaved(const QString &filePath)
+{
+    if (!m_dependenciesValid)
+        return;
+    const PathTable::Id id = m_paths->find(filePath);
+    if (id != PathTable::InvalidId)
+        m_dependencies.fileChanged(id);
+}
+
+/**
+ * Expands environment variables in the given \a string when they are written
+ * like $$(VARIABLE).
+ */
+static void expandEnvironmentVariables(const QProcessEnvironment &env, QString &string)
+{
+    static QRegExp candidate(QLatin1String("\\$\\$\\((.+)\\)"));
+
+    int index = candidate.indexIn(string);
+    while (index != -1) {
+        const QString value = env.value(candidate.cap(1));
+
+        string.replace(index, candidate.matchedLength(), value);
+        index += value.length();
+
+        index = candidate.indexIn(string, index);
+    }
+}
+
+/**
+ * Expands environment variables and converts the path from relative to the
+ * project to an absolute path.
+ *
+ * The returned absolute paths are interned in the project's path table. The
+ * \a map variable is an optional argument that will map them back to the
+ * index of their original entry in \a paths.
+ */
+QVector<PathTable::Id> dBaseProject::processEntries(const QStringList &paths,
+                                                    QHash<PathTable::Id, int> *map)
+{
+    DBASE_TRACE_SCOPE("dBaseProject::processEntries");
+    const QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    const QDir projectDir(projectDirectory().toString());
+
+    QFileInfo fileInfo;
+    QVector<PathTable::Id> absolutePaths;
+    QSet<PathTable::Id> seen;
+    for (int index = 0; index < paths.size(); ++index) {
+        QString trimmedPath = paths.at(index).trimmed();
+        if (trimmedPath.isEmpty())
+            continue;
+
+        expandEnvironmentVariables(env, trimmedPath);
+
+        trimmedPath = FileName::fromUserInput(trimmedPath).toString();
+
+        fileInfo.setFile(projectDir, trimmedPath);
+        if (fileInfo.exists()) {
+            const PathTable::Id id = m_paths->intern(fileInfo.absoluteFilePath());
+            if (!seen.contains(id)) {
+                seen.insert(id);
+                absolutePaths.append(id);
+            }
+            if (map)
+                map->insert(id, index);
+        }
+    }
+    return absolutePaths;
+}
+
+Project::RestoreResult dBaseProject::fromMap(const QVariantMap &map, QString *errorMessage)
+{
+    Project::RestoreResult res = Project::fromMap(map, errorMessage);
+    if (res == RestoreResult::Ok) {
+        refresh();
+
+        Kit *defaultKit = KitManager::defaultKit();
+        if (!activeTarget() && defaultKit)
+            addTarget(createTarget(defaultKit));
+    }
+
+    return res;
+}
+
+dBaseProjectNode::dBaseProjectNode(dBaseProject *project)
+    : ProjectNode(project->projectDirectory())
+    , m_project(project)
+{
+    setDisplayName(project->projectFilePath().toFileInfo().completeBaseName());
+}
+
+bool dBaseProjectNode::showInSimpleTree() const
+{
+    return true;
+}
+
+QString dBaseProjectNode::addFileFilter() const
+{
+    return QLatin1String("*.dfm");
+}
+
+bool dBaseProjectNode::renameFile(const QString &filePath, const QString &newFilePath)
+{
+    return m_project->renameFile(filePath, newFilePath);
+}
+
+}  // namespace Internal
+}  // namespace dBaseEditor
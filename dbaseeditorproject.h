@@ -0,0 +1,68 @@
+#pragma once
+
+#include "dbaseeditordependencygraph.h"
+#include "dbaseeditorpathtable.h"
+
+#include <projectexplorer/project.h>
+#include <projectexplorer/projectnodes.h>
+
+#include <QHash>
+#include <QSharedPointer>
+#include <QStringList>
+
+namespace dBaseEditor {
+namespace Internal {
+
+class dBaseProject : public ProjectExplorer::Project
+{
+public:
+    explicit dBaseProject(const Utils::FileName &filename);
+
+    bool addFiles(const QStringList &filePaths);
+    bool removeFiles(const QStringList &filePaths);
+    bool setFiles(const QStringList &filePaths);
+    bool renameFile(const QString &filePath, const QString &newFilePath);
+    void refresh();
+
+    QStringList filesAffectedBy(const QString &filePath);
+    Definitions preprocessorDefinitions(const QString &filePath);
+
+private:
+#ifdef WITH_TESTS
+    friend class dBaseBenchmark;
+#endif
+
+    RestoreResult fromMap(const QVariantMap &map, QString *errorMessage) override;
+
+    bool saveRawFileList(const QStringList &rawFileList);
+    bool saveRawList(const QStringList &rawList, const QString &fileName);
+
+    void parseProject();
+    QVector<PathTable::Id> processEntries(const QStringList &paths,
+                                          QHash<PathTable::Id, int> *map = 0);
+    void updateDependencies();
+    void documentSaved(const QString &filePath);
+
+    QSharedPointer<PathTable> m_paths; // shared with the file nodes
+    QStringList m_rawFileList;
+    QVector<PathTable::Id> m_files;
+    QHash<PathTable::Id, int> m_rawListEntries; // path id -> index in m_rawFileList
+    DependencyGraph m_dependencies;
+    bool m_dependenciesValid = false;
+};
+
+class dBaseProjectNode : public ProjectExplorer::ProjectNode
+{
+public:
+    dBaseProjectNode(dBaseProject *project);
+
+    bool showInSimpleTree() const override;
+    QString addFileFilter() const override;
+    bool renameFile(const QString &filePath, const QString &newFilePath) override;
+
+private:
+    dBaseProject *m_project;
+};
+
+}  // namespace Internal
+}  // namespace dBaseEditor
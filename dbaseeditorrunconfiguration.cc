@@ -0,0 +1,239 @@
+#include "dbaseeditorrunconfiguration.h"
+#include "dbaseeditorproject.h"
+#include "dbaseeditortrace.h"
+
+#include <projectexplorer/localenvironmentaspect.h>
+#include <projectexplorer/runconfigurationaspects.h>
+#include <projectexplorer/runnables.h>
+#include <projectexplorer/target.h>
+
+#include <utils/detailswidget.h>
+#include <utils/environment.h>
+#include <utils/fancylineedit.h>
+#include <utils/qtcassert.h>
+#include <utils/qtcprocess.h>
+
+#include <QFormLayout>
+#include <QLabel>
+
+using namespace ProjectExplorer;
+using namespace Utils;
+
+namespace dBaseEditor {
+namespace Internal {
+
+const char dBaseRunConfigurationPrefix[] = "dBaseEditor.RunConfiguration.";
+const char InterpreterKey[] = "dBaseEditor.RunConfiguation.Interpreter";
+const char MainScriptKey[] = "dBaseEditor.RunConfiguation.MainScript";
+
+static QString scriptFromId(Core::Id id)
+{
+    return id.suffixAfter(dBaseRunConfigurationPrefix);
+}
+
+static Core::Id idFromScript(const QString &target)
+{
+    return Core::Id(dBaseRunConfigurationPrefix).withSuffix(target);
+}
+
+class dBaseRunConfigurationWidget : public QWidget
+{
+//    Q_OBJECT
+public:
+    dBaseRunConfigurationWidget(dBaseRunConfiguration *runConfiguration, QWidget *parent = 0);
+    void setInterpreter(const QString &interpreter);
+
+private:
+    dBaseRunConfiguration *m_runConfiguration;
+    DetailsWidget *m_detailsContainer;
+    FancyLineEdit *m_interpreterChooser;
+    QLabel *m_scriptLabel;
+};
+
+////////////////////////////////////////////////////////////////
+
+dBaseRunConfiguration::dBaseRunConfiguration(Target *target)
+    : RunConfiguration(target)
+{
+    addExtraAspect(new LocalEnvironmentAspect(this, LocalEnvironmentAspect::BaseEnvironmentModifier()));
+    addExtraAspect(new ArgumentsAspect(this, "dBaseEditor.RunConfiguration.Arguments"));
+    addExtraAspect(new TerminalAspect (this, "dBaseEditor.RunConfiguration.UseTerminal"));
+    setDefaultDisplayName(defaultDisplayName());
+}
+
+void dBaseRunConfiguration::initialize(Core::Id id)
+{
+    DBASE_TRACE_SCOPE("dBaseRunConfiguration::initialize");
+    RunConfiguration::initialize(id);
+
+    m_mainScript = scriptFromId(id);
+    setDisplayName(defaultDisplayName());
+
+    Environment sysEnv = Environment::systemEnvironment();  // hier
+    const QString exec = sysEnv.searchInPath("dir").toString();
+    m_interpreter = exec.isEmpty() ? "dir" : exec;
+}
+
+QVariantMap dBaseRunConfiguration::toMap() const
+{
+    QVariantMap map(RunConfiguration::toMap());
+    map.insert(MainScriptKey, m_mainScript);
+    map.insert(InterpreterKey, m_interpreter);
+    return map;
+}
+
+bool dBaseRunConfiguration::fromMap(const QVariantMap &map)
+{
+    m_mainScript = map.value(MainScriptKey).toString();
+    m_interpreter = map.value(InterpreterKey).toString();
+    return RunConfiguration::fromMap(map);
+}
+
+QString dBaseRunConfiguration::defaultDisplayName() const
+{
+    return tr("Run %1").arg(m_mainScript);
+}
+
+QWidget *dBaseRunConfiguration::createConfigurationWidget()
+{
+    return new dBaseRunConfigurationWidget(this);
+}
+
+Runnable dBaseRunConfiguration::runnable() const
+{
+    StandardRunnable r;
+    QtcProcess::addArg(&r.commandLineArguments, m_mainScript);
+    QtcProcess::addArgs(&r.commandLineArguments, extraAspect<ArgumentsAspect>()->arguments());
+    r.executable = m_interpreter;
+    r.runMode = extraAspect<TerminalAspect>()->runMode();
+    r.environment = extraAspect<EnvironmentAspect>()->environment();
+    return r;
+}
+
+QString dBaseRunConfiguration::arguments() const
+{
+    auto aspect = extraAspect<ArgumentsAspect>();
+    QTC_ASSERT(aspect, return QString());
+    return aspect->arguments();
+}
+
+dBaseRunConfigurationWidget::dBaseRunConfigurationWidget(dBaseRunConfiguration *runConfiguration, QWidget *parent)
+    : QWidget(parent), m_runConfiguration(runConfiguration)
+{
+    auto fl = new QFormLayout();
+    fl->setMargin(0);
+    fl->setFieldGrowthPolicy(QFormLayout::ExpandingFieldsGrow);
+
+    m_interpreterChooser = new FancyLineEdit(this);
+    m_interpreterChooser->setText(runConfiguration->interpreter());
+    connect(m_interpreterChooser, &QLineEdit::textChanged,
+            this, &dBaseRunConfigurationWidget::setInterpreter);
+
+    m_scriptLabel = new QLabel(this);
+    m_scriptLabel->setText(runConfiguration->mainScript());
+
+    fl->addRow(tr("Interpreter: "), m_interpreterChooser);
+    fl->addRow(tr("Script: "), m_scriptLabel);
+    runConfiguration->extraAspect<ArgumentsAspect>()->addToMainConfigurationWidget(this, fl);
+    runConfiguration->extraAspect<TerminalAspect>()->addToMainConfigurationWidget(this, fl);
+
+    m_detailsContainer = new DetailsWidget(this);
+    m_detailsContainer->setState(DetailsWidget::NoSummary);
+
+    auto details = new QWidget(m_detailsContainer);
+    m_detailsContainer->setWidget(details);
+    details->setLayout(fl);
+
+    auto vbx = new QVBoxLayout(this);
+    vbx->setMargin(0);
+    vbx->addWidget(m_detailsContainer);
+}
+
+// dBaseRunConfigurationWidget
+
+void dBaseRunConfigurationWidget::setInterpreter(const QString &interpreter)
+{
+    m_runConfiguration->setInterpreter(interpreter);
+}
+
+////////////////////////////////////////////////////////////////
+
+QList<Core::Id> runConfigurationIdsForProject(const Project *project)
+{
+    DBASE_TRACE_SCOPE("runConfigurationIdsForProject");
+    QList<Core::Id> allIds;
+    foreach (const QString &file, project->files(ProjectExplorer::Project::AllFiles))
+        allIds.append(idFromScript(file));
+    return allIds;
+}
+
+dBaseRunConfigurationFactory::dBaseRunConfigurationFactory()
+{
+    setObjectName("dBaseRunConfigurationFactory");
+}
+
+QList<Core::Id> dBaseRunConfigurationFactory::availableCreationIds(Target *parent, CreationMode mode) const
+{
+    Q_UNUSED(mode);
+    if (!canHandle(parent))
+        return {};
+    //return { Core::Id(dBaseExecutableId) };
+
+    return runConfigurationIdsForProject(parent->project());
+}
+
+QString dBaseRunConfigurationFactory::displayNameForId(Core::Id id) const
+{
+    return scriptFromId(id);
+}
+
+bool dBaseRunConfigurationFactory::canCreate(Target *parent, Core::Id id) const
+{
+    DBASE_TRACE_SCOPE("dBaseRunConfigurationFactory::canCreate");
+    if (!canHandle(parent))
+        return false;
+    dBaseProject *project = static_cast<dBaseProject *>(parent->project());
+    const QString script = scriptFromId(id);
+    if (script.endsWith(".dbgprj"))
+        return false;
+    return project->files(ProjectExplorer::Project::AllFiles).contains(script);
+}
+
+bool dBaseRunConfigurationFactory::canRestore(Target *parent, const QVariantMap &map) const
+{
+    Q_UNUSED(parent);
+    return idFromMap(map).name().startsWith(dBaseRunConfigurationPrefix);
+}
+
+bool dBaseRunConfigurationFactory::canClone(Target *parent, RunConfiguration *source) const
+{
+    if (!canHandle(parent))
+        return false;
+    return source->id().name().startsWith(dBaseRunConfigurationPrefix);
+}
+
+RunConfiguration *dBaseRunConfigurationFactory::clone(Target *parent, RunConfiguration *source)
+{
+    if (!canClone(parent, source))
+        return 0;
+    return cloneHelper<dBaseRunConfiguration>(parent, source);
+}
+
+bool dBaseRunConfigurationFactory::canHandle(Target *parent) const
+{
+    return dynamic_cast<dBaseProject *>(parent->project());
+}
+
+RunConfiguration *dBaseRunConfigurationFactory::doCreate(Target *parent, Core::Id id)
+{
+    return createHelper<dBaseRunConfiguration>(parent, id);
+}
+
+RunConfiguration *dBaseRunConfigurationFactory::doRestore(Target *parent, const QVariantMap &map)
+{
+    return createHelper<dBaseRunConfiguration>(parent, idFromMap(map));
+}
+
+
+}  // namespace Internal
+}  // namespace dBaseEditor
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <projectexplorer/runconfiguration.h>
+
+namespace dBaseEditor {
+namespace Internal {
+
+class dBaseRunConfiguration : public ProjectExplorer::RunConfiguration
+{
+//    Q_OBJECT
+
+    Q_PROPERTY(bool supportsDebugger READ supportsDebugger)
+    Q_PROPERTY(QString interpreter READ interpreter)
+    Q_PROPERTY(QString mainScript READ mainScript)
+    Q_PROPERTY(QString arguments READ arguments)
+
+public:
+    explicit dBaseRunConfiguration(ProjectExplorer::Target *target);
+
+    QWidget *createConfigurationWidget() override;
+    QVariantMap toMap() const override;
+    bool fromMap(const QVariantMap &map) override;
+    ProjectExplorer::Runnable runnable() const override;
+
+    bool supportsDebugger() const { return true; }
+    QString mainScript() const { return m_mainScript; }
+    QString arguments() const;
+    QString interpreter() const { return m_interpreter; }
+    void setInterpreter(const QString &interpreter) { m_interpreter = interpreter; }
+
+private:
+    friend class ProjectExplorer::IRunConfigurationFactory;
+    void initialize(Core::Id id);
+
+    QString defaultDisplayName() const; // { return QString("dBaseDefaultName"); }
+
+    QString m_interpreter;
+    QString m_mainScript;
+};
+
+class dBaseRunConfigurationFactory : public ProjectExplorer::IRunConfigurationFactory
+{
+public:
+    dBaseRunConfigurationFactory();
+
+    QList<Core::Id> availableCreationIds(ProjectExplorer::Target *parent,
+                                         CreationMode mode) const override;
+    QString displayNameForId(Core::Id id) const override;
+
+    bool canCreate(ProjectExplorer::Target *parent, Core::Id id) const override;
+    bool canRestore(ProjectExplorer::Target *parent, const QVariantMap &map) const override;
+    bool canClone(ProjectExplorer::Target *parent,
+                  ProjectExplorer::RunConfiguration *source) const override;
+    ProjectExplorer::RunConfiguration *clone(ProjectExplorer::Target *parent,
+                                             ProjectExplorer::RunConfiguration *source) override;
+
+private:
+    bool canHandle(ProjectExplorer::Target *parent) const;
+
+    ProjectExplorer::RunConfiguration *doCreate(ProjectExplorer::Target *parent,
+                                                Core::Id id) override;
+    ProjectExplorer::RunConfiguration *doRestore(ProjectExplorer::Target *parent,
+                                                 const QVariantMap &map) override;
+};
+
+/**
+ * @brief Run configuration ids offered for the files of a dBase \a project.
+ */
+QList<Core::Id> runConfigurationIdsForProject(const ProjectExplorer::Project *project);
+
+}  // namespace Internal
+}  // namespace dBaseEditor
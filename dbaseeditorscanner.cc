@@ -1,15 +1,208 @@
 #include "dbaseeditorscanner.h"
 
-#include <QChar>
+#include <QSet>
 
 namespace dBaseEditor {
 namespace Internal {
 
 Scanner::Scanner(const QChar *text, const int length)
+    : m_text(text)
+    , m_textLength(length)
 {
-    Q_UNUSED(text)
-    Q_UNUSED(length)
 }
 
-}  // Internal
-}  // dBaseEditor
+void Scanner::setState(int state)
+{
+    m_state = state;
+}
+
+int Scanner::state() const
+{
+    return m_state;
+}
+
+FormatToken Scanner::read()
+{
+    if (m_position >= m_textLength)
+        return FormatToken(Format_EndOfBlock, m_position, 0);
+
+    if (m_state == State_MultiLineComment)
+        return readMultiLineComment(m_position);
+
+    return onDefaultState();
+}
+
+QString Scanner::value(const FormatToken &tk) const
+{
+    return QString(m_text + tk.begin(), tk.length());
+}
+
+QChar Scanner::peek(int offset) const
+{
+    const int position = m_position + offset;
+    return position < m_textLength ? m_text[position] : QChar();
+}
+
+void Scanner::move(int offset)
+{
+    m_position = qMin(m_position + offset, m_textLength);
+}
+
+FormatToken Scanner::onDefaultState()
+{
+    const int start = m_position;
+    const QChar first = peek();
+
+    if (first.isSpace())
+        return readWhiteSpace(start);
+
+    const bool atStatementStart = m_atStatementStart;
+    m_atStatementStart = false;
+
+    if (first == '/' && peek(1) == '*') {
+        move(2);
+        m_state = State_MultiLineComment;
+        return readMultiLineComment(start);
+    }
+    if ((first == '/' && peek(1) == '/') || (first == '&' && peek(1) == '&'))
+        return readLineComment(start);
+    // '*' starts a comment only where a command is expected
+    if (first == '*' && atStatementStart)
+        return readLineComment(start);
+    if (first == '#' && atStatementStart)
+        return readPreprocessor(start);
+    if (first == '"' || first == '\'')
+        return readString(first, start);
+    if (first.isDigit())
+        return readNumber(start);
+    if (first.isLetter() || first == '_')
+        return readIdentifier(start);
+    if (first == '.')
+        return readDotOperator(start);
+
+    return readOperator(start);
+}
+
+FormatToken Scanner::readMultiLineComment(int start)
+{
+    while (m_position < m_textLength) {
+        if (peek() == '*' && peek(1) == '/') {
+            move(2);
+            m_state = State_Default;
+            break;
+        }
+        move();
+    }
+    return FormatToken(Format_Comment, start, m_position - start);
+}
+
+FormatToken Scanner::readLineComment(int start)
+{
+    while (m_position < m_textLength && peek() != '\n')
+        move();
+    return FormatToken(Format_Comment, start, m_position - start);
+}
+
+FormatToken Scanner::readString(QChar quote, int start)
+{
+    move();
+    while (m_position < m_textLength && peek() != '\n') {
+        const QChar c = peek();
+        move();
+        if (c == quote)
+            break;
+    }
+    return FormatToken(Format_String, start, m_position - start);
+}
+
+FormatToken Scanner::readNumber(int start)
+{
+    while (peek().isDigit())
+        move();
+    if (peek() == '.' && peek(1).isDigit()) {
+        move();
+        while (peek().isDigit())
+            move();
+    }
+    if ((peek() == 'e' || peek() == 'E')
+            && (peek(1).isDigit() || ((peek(1) == '+' || peek(1) == '-') && peek(2).isDigit()))) {
+        move(2);
+        while (peek().isDigit())
+            move();
+    }
+    return FormatToken(Format_Number, start, m_position - start);
+}
+
+FormatToken Scanner::readIdentifier(int start)
+{
+    while (peek().isLetterOrNumber() || peek() == '_')
+        move();
+
+    const QString name(m_text + start, m_position - start);
+    if (isKeyword(name))
+        return FormatToken(Format_Keyword, start, m_position - start);
+    return FormatToken(Format_Identifier, start, m_position - start);
+}
+
+FormatToken Scanner::readPreprocessor(int start)
+{
+    move();
+    while (peek().isLetter())
+        move();
+    return FormatToken(Format_Preprocessor, start, m_position - start);
+}
+
+/**
+ * Reads the logical literals and operators written between dots, like .T.,
+ * .AND. or .NOT.; a single dot is an ordinary operator.
+ */
+FormatToken Scanner::readDotOperator(int start)
+{
+    int length = 1;
+    while (peek(length).isLetter())
+        ++length;
+    if (length > 1 && peek(length) == '.') {
+        move(length + 1);
+        return FormatToken(Format_Keyword, start, m_position - start);
+    }
+    if (peek(1).isDigit())
+        return readNumber(start);
+    return readOperator(start);
+}
+
+FormatToken Scanner::readOperator(int start)
+{
+    move();
+    return FormatToken(Format_Operator, start, m_position - start);
+}
+
+FormatToken Scanner::readWhiteSpace(int start)
+{
+    while (m_position < m_textLength && peek().isSpace()) {
+        if (peek() == '\n')
+            m_atStatementStart = true;
+        move();
+    }
+    return FormatToken(Format_Whitespace, start, m_position - start);
+}
+
+bool Scanner::isKeyword(const QString &name) const
+{
+    static const QSet<QString> keywords = {
+        "ACCEPT", "ADDITIVE", "ALIAS", "APPEND", "BEGINTRANS", "CASE", "CATCH",
+        "CLASS", "CLEAR", "CLOSE", "COMMIT", "COPY", "CREATE", "DATABASE",
+        "DEFINE", "DELETE", "DO", "ELSE", "ELSEIF", "ENDCASE", "ENDCLASS",
+        "ENDDO", "ENDFOR", "ENDIF", "ENDSCAN", "ENDTRY", "ENDWITH", "EXIT",
+        "EXTERN", "FINALLY", "FOR", "FROM", "FUNCTION", "GO", "GOTO", "IF",
+        "INDEX", "LOCAL", "LOCATE", "LOOP", "NEW", "NEXT", "NOTE", "OF",
+        "ON", "OTHERWISE", "PARAMETERS", "PRIVATE", "PROCEDURE", "PROTECT",
+        "PUBLIC", "QUIT", "RECALL", "RELEASE", "REPLACE", "RETURN",
+        "ROLLBACK", "SCAN", "SEEK", "SELECT", "SET", "SKIP", "STATIC", "STEP",
+        "STORE", "SUPER", "THIS", "THROW", "TO", "TRY", "USE", "WHILE",
+        "WITH", "ZAP"
+    };
+    return keywords.contains(name.toUpper());
+}
+
+}  // namespace Internal
+}  // namespace dBaseEditor
@@ -1,16 +1,56 @@
 #pragma once
 
-//#include "dbaseformattoken.h"
+#include "dbaseformattoken.h"
 
 #include <QChar>
+#include <QString>
 
 namespace dBaseEditor {
 namespace Internal {
 
+/**
+ * @brief Splits dBase source text into format tokens.
+ *
+ * Works on a single block for highlighting as well as on a whole file; the
+ * state carries an open block comment from one call to the next.
+ */
 class Scanner
 {
 public:
+    enum State {
+        State_Default,
+        State_MultiLineComment
+    };
+
     Scanner(const QChar *text, const int length);
+
+    void setState(int state);
+    int state() const;
+
+    FormatToken read();
+    QString value(const FormatToken &tk) const;
+
+private:
+    FormatToken onDefaultState();
+    FormatToken readMultiLineComment(int start);
+    FormatToken readLineComment(int start);
+    FormatToken readString(QChar quote, int start);
+    FormatToken readNumber(int start);
+    FormatToken readIdentifier(int start);
+    FormatToken readPreprocessor(int start);
+    FormatToken readDotOperator(int start);
+    FormatToken readOperator(int start);
+    FormatToken readWhiteSpace(int start);
+
+    QChar peek(int offset = 0) const;
+    void move(int offset = 1);
+    bool isKeyword(const QString &name) const;
+
+    const QChar *m_text;
+    const int m_textLength;
+    int m_position = 0;
+    int m_state = State_Default;
+    bool m_atStatementStart = true;
 };
 
 }  // namespace Internal
@@ -0,0 +1,204 @@
+#include "dbaseeditortest.h"
+#include "dbaseeditordependencygraph.h"
+#include "dbaseeditorhighlighter.h"
+#include "dbaseeditorproject.h"
+#include "dbaseeditorscanner.h"
+
+#include <texteditor/textdocument.h>
+#include <texteditor/texteditor.h>
+
+#include <utils/fileutils.h>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QScopedPointer>
+#include <QTest>
+#include <QTextBlock>
+#include <QTextCursor>
+
+using namespace Utils;
+
+namespace dBaseEditor {
+namespace Internal {
+
+void dBaseEditorTest::initTestCase()
+{
+    QVERIFY(m_directory.isValid());
+}
+
+QString dBaseEditorTest::testDirectory() const
+{
+    return QDir::cleanPath(m_directory.path() + '/' + QTest::currentTestFunction());
+}
+
+/**
+ * Writes \a contents to \a name in the directory of the current test and
+ * returns the absolute file name.
+ */
+QString dBaseEditorTest::writeSource(const QString &name, const QString &contents)
+{
+    const QString fileName = testDirectory() + '/' + name;
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+    QFile file(fileName);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+        return QString();
+    file.write(contents.toUtf8());
+    return fileName;
+}
+
+void dBaseEditorTest::lineContinuation()
+{
+    const QString main = writeSource("main.prg", "SET PROCEDURE TO ;\n"
+                                                 "   utils ADDITIVE\n"
+                                                 "DO Start\n");
+    const QString utils = writeSource("utils.prg", "PROCEDURE Start\nRETURN\n");
+
+    PathTable paths;
+    paths.setBaseDirectory(testDirectory());
+    DependencyGraph graph(&paths);
+    graph.update({ paths.intern(main) });
+
+    const QVector<PathTable::Id> expected = { paths.find(utils) };
+    QCOMPARE(graph.dependencies(paths.find(main)), expected);
+}
+
+void dBaseEditorTest::setProcedureAbbreviation()
+{
+    const QString main = writeSource("main.prg", "set proc to lib1, \"lib2.prg\" additive\n"
+                                                 "SET PROCEDURES TO lib3\n");
+    const QString lib1 = writeSource("lib1.prg", "RETURN\n");
+    const QString lib2 = writeSource("lib2.prg", "RETURN\n");
+    writeSource("lib3.prg", "RETURN\n");
+
+    PathTable paths;
+    paths.setBaseDirectory(testDirectory());
+    DependencyGraph graph(&paths);
+    graph.update({ paths.intern(main) });
+
+    // PROCEDURES is not an abbreviation of PROCEDURE
+    const QVector<PathTable::Id> expected = { paths.find(lib1), paths.find(lib2) };
+    QCOMPARE(graph.dependencies(paths.find(main)), expected);
+    QCOMPARE(graph.dependents(paths.find(lib2)), QSet<PathTable::Id>({ paths.find(main) }));
+}
+
+void dBaseEditorTest::includeForms()
+{
+    const QString main = writeSource("main.prg", "#include \"quoted.h\"\n"
+                                                 "#include <angled.h>\n"
+                                                 "#include \"missing.h\"\n");
+    const QString quoted = writeSource("quoted.h", "#define QUOTED 1\n");
+    const QString angled = writeSource("angled.h", "#define ANGLED \"two\"\n");
+
+    PathTable paths;
+    paths.setBaseDirectory(testDirectory());
+    DependencyGraph graph(&paths);
+    graph.update({ paths.intern(main) });
+
+    const QVector<PathTable::Id> expected = { paths.find(quoted), paths.find(angled) };
+    QCOMPARE(graph.dependencies(paths.find(main)), expected);
+
+    const Definitions definitions = graph.definitions(paths.find(main));
+    QCOMPARE(definitions.value("QUOTED"), QString("1"));
+    QCOMPARE(definitions.value("ANGLED"), QString("\"two\""));
+}
+
+void dBaseEditorTest::includeCycle()
+{
+    const QString a = writeSource("a.h", "#include \"b.h\"\n#define A 1\n");
+    const QString b = writeSource("b.h", "#include \"a.h\"\n#define B 2\n");
+
+    PathTable paths;
+    paths.setBaseDirectory(testDirectory());
+    const PathTable::Id idA = paths.intern(a);
+    const PathTable::Id idB = paths.intern(b);
+
+    // The result for b.h must not depend on a.h having been expanded first
+    DependencyGraph graph(&paths);
+    graph.update({ idA, idB });
+    graph.definitions(idA);
+    const Definitions afterA = graph.definitions(idB);
+
+    DependencyGraph fresh(&paths);
+    fresh.update({ idA, idB });
+    const Definitions direct = fresh.definitions(idB);
+
+    QCOMPARE(afterA, direct);
+    QCOMPARE(direct.value("A"), QString("1"));
+    QCOMPARE(direct.value("B"), QString("2"));
+}
+
+void dBaseEditorTest::invalidateAfterChange()
+{
+    const QString main = writeSource("main.prg", "#include \"defs.h\"\n? VERSION\n");
+    const QString defs = writeSource("defs.h", "#define VERSION 1\n");
+
+    PathTable paths;
+    paths.setBaseDirectory(testDirectory());
+    const PathTable::Id idMain = paths.intern(main);
+    const PathTable::Id idDefs = paths.intern(defs);
+    DependencyGraph graph(&paths);
+    graph.update({ idMain, idDefs });
+    QCOMPARE(graph.definitions(idMain).value("VERSION"), QString("1"));
+
+    // Saving without changing the dependencies keeps the memoized results
+    QVERIFY(graph.fileChanged(idDefs).isEmpty());
+
+    // Rewritten within the same second: the modification time may not differ
+    writeSource("defs.h", "#define VERSION 2\n");
+    QCOMPARE(graph.fileChanged(idDefs), QSet<PathTable::Id>({ idMain, idDefs }));
+    QCOMPARE(graph.definitions(idMain).value("VERSION"), QString("2"));
+}
+
+void dBaseEditorTest::projectQueries()
+{
+    const QString main = writeSource("main.prg", "SET PROCEDURE TO lib\n");
+    const QString lib = writeSource("lib.prg", "#include \"defs.h\"\n");
+    const QString defs = writeSource("defs.h", "#define DEBUG .T.\n");
+    const QString projectFile = writeSource("test.dbgprj", "main.prg\nlib.prg\n");
+
+    QScopedPointer<dBaseProject> project(new dBaseProject(FileName::fromString(projectFile)));
+    project->refresh();
+
+    QStringList affected = project->filesAffectedBy(defs);
+    affected.sort();
+    QStringList expected = { defs, lib, main };
+    expected.sort();
+    QCOMPARE(affected, expected);
+
+    QCOMPARE(project->preprocessorDefinitions(lib).value("DEBUG"), QString(".T."));
+    QVERIFY(!project->preprocessorDefinitions(main).contains("DEBUG"));
+}
+
+/**
+ * Opening and closing a block comment in an edited line has to re-highlight
+ * the lines below it, which were highlighted with the old state. The
+ * highlighter updates from a zero timer, hence the QTRY_ variants.
+ */
+void dBaseEditorTest::visibleRegionBlockComment()
+{
+    TextEditor::TextEditorWidget widget;
+    widget.setTextDocument(TextEditor::TextDocumentPtr(new TextEditor::TextDocument));
+    widget.setPlainText("x = 1\ny = 2\nz = 3\n");
+    widget.resize(400, 300);
+    new dBaseVisibleRegionHighlighter(&widget);
+
+    QTextDocument *document = widget.document();
+    const QTextBlock below = document->findBlockByNumber(2);
+    QTRY_COMPARE(dBaseVisibleRegionHighlighter::endState(below), int(Scanner::State_Default));
+
+    QTextCursor cursor(document->findBlockByNumber(1));
+    cursor.insertText("/* ");
+    QTRY_COMPARE(dBaseVisibleRegionHighlighter::endState(document->findBlockByNumber(1)),
+                 int(Scanner::State_MultiLineComment));
+    QTRY_COMPARE(dBaseVisibleRegionHighlighter::endState(below),
+                 int(Scanner::State_MultiLineComment));
+
+    cursor.movePosition(QTextCursor::StartOfBlock);
+    cursor.movePosition(QTextCursor::NextCharacter, QTextCursor::KeepAnchor, 3);
+    cursor.removeSelectedText();
+    QTRY_COMPARE(dBaseVisibleRegionHighlighter::endState(below), int(Scanner::State_Default));
+}
+
+}  // namespace Internal
+}  // namespace dBaseEditor
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QObject>
+#include <QTemporaryDir>
+
+namespace dBaseEditor {
+namespace Internal {
+
+/**
+ * @brief Tests for the SET PROCEDURE TO / #include dependency graph and
+ *        the large-file highlighter.
+ *
+ * Run with "qtcreator -test dBaseEditor" on a build with TEST=1. Every test
+ * writes its sources into its own directory below a temporary directory.
+ */
+class dBaseEditorTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void lineContinuation();
+    void setProcedureAbbreviation();
+    void includeForms();
+    void includeCycle();
+    void invalidateAfterChange();
+    void projectQueries();
+    void visibleRegionBlockComment();
+
+private:
+    QString writeSource(const QString &name, const QString &contents);
+    QString testDirectory() const;
+
+    QTemporaryDir m_directory;
+};
+
+}  // namespace Internal
+}  // namespace dBaseEditor
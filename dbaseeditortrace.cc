@@ -0,0 +1,201 @@
+#include "dbaseeditortrace.h"
+
+#include <coreplugin/icore.h>
+
+#include <utils/fileutils.h>
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QSettings>
+
+#include <chrono>
+
+using namespace Utils;
+
+namespace dBaseEditor {
+namespace Internal {
+namespace Trace {
+
+const char TraceFileEnvironmentVariable[] = "DBASE_TRACE_FILE";
+const char TraceEnabledKey[] = "dBaseEditor/TraceEnabled";
+const char TraceFileKey[] = "dBaseEditor/TraceFile";
+
+const int BufferCapacity = 1 << 16;
+
+std::atomic<bool> g_enabled(false);
+
+struct Event
+{
+    const char *name;
+    qint64 start;
+    qint64 duration;
+};
+
+/**
+ * @brief Events of one thread. Only the owning thread writes; the size is
+ *        published with release semantics so dump() can read concurrently.
+ *        A buffer of an older session is emptied by its owner on the next
+ *        record() rather than by the thread starting the session.
+ */
+struct ThreadBuffer
+{
+    int threadId = 0;
+    std::atomic<int> session{0};
+    std::atomic<int> size{0};
+    std::atomic<int> dropped{0};
+    ThreadBuffer *next = 0;
+    Event events[BufferCapacity];
+};
+
+static std::atomic<ThreadBuffer *> s_buffers(nullptr);
+static std::atomic<int> s_threadCount(0);
+static std::atomic<int> s_session(0);
+static const std::chrono::steady_clock::time_point s_epoch = std::chrono::steady_clock::now();
+static QString s_traceFile;
+
+static ThreadBuffer *threadBuffer()
+{
+    static thread_local ThreadBuffer *buffer = 0;
+    if (!buffer) {
+        buffer = new ThreadBuffer;
+        buffer->threadId = ++s_threadCount;
+        ThreadBuffer *head = s_buffers.load(std::memory_order_acquire);
+        do {
+            buffer->next = head;
+        } while (!s_buffers.compare_exchange_weak(head, buffer,
+                                                  std::memory_order_release,
+                                                  std::memory_order_acquire));
+    }
+    return buffer;
+}
+
+qint64 now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - s_epoch).count();
+}
+
+void record(const char *name, qint64 start, qint64 end)
+{
+    ThreadBuffer *buffer = threadBuffer();
+    const int session = s_session.load(std::memory_order_acquire);
+    if (buffer->session.load(std::memory_order_relaxed) != session) {
+        buffer->size.store(0, std::memory_order_relaxed);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+        buffer->session.store(session, std::memory_order_release);
+    }
+
+    const int index = buffer->size.load(std::memory_order_relaxed);
+    if (index >= BufferCapacity) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer->events[index] = { name, start, end - start };
+    buffer->size.store(index + 1, std::memory_order_release);
+}
+
+void initialize()
+{
+    s_traceFile = QString::fromLocal8Bit(qgetenv(TraceFileEnvironmentVariable));
+    bool enabled = !s_traceFile.isEmpty();
+
+    if (QSettings *settings = Core::ICore::settings()) {
+        if (s_traceFile.isEmpty())
+            s_traceFile = settings->value(TraceFileKey).toString();
+        enabled = enabled || settings->value(TraceEnabledKey, false).toBool();
+    }
+
+    if (s_traceFile.isEmpty())
+        s_traceFile = QDir::temp().filePath("dbase-trace.json");
+
+    g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void shutdown()
+{
+    if (isEnabled())
+        dump(s_traceFile);
+}
+
+/**
+ * Switching tracing on starts a new session, so the next dump only holds the
+ * events recorded from now on.
+ */
+void setEnabled(bool enabled)
+{
+    if (enabled && !g_enabled.load(std::memory_order_relaxed))
+        s_session.fetch_add(1, std::memory_order_release);
+    g_enabled.store(enabled, std::memory_order_relaxed);
+    if (QSettings *settings = Core::ICore::settings())
+        settings->setValue(TraceEnabledKey, enabled);
+}
+
+QString traceFile()
+{
+    return s_traceFile;
+}
+
+static void appendEscaped(QByteArray &out, const char *name)
+{
+    for (const char *c = name; *c; ++c) {
+        if (*c == '"' || *c == '\\')
+            out += '\\';
+        out += *c;
+    }
+}
+
+bool dump(const QString &fileName, QString *errorMessage)
+{
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+
+    QByteArray out;
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    const int session = s_session.load(std::memory_order_acquire);
+    for (ThreadBuffer *buffer = s_buffers.load(std::memory_order_acquire);
+         buffer; buffer = buffer->next) {
+        // Nothing recorded by this thread in the current session
+        if (buffer->session.load(std::memory_order_acquire) != session)
+            continue;
+
+        const QByteArray tid = QByteArray::number(buffer->threadId);
+        const int size = buffer->size.load(std::memory_order_acquire);
+        for (int i = 0; i < size; ++i) {
+            const Event &event = buffer->events[i];
+            if (!first)
+                out += ",\n";
+            first = false;
+            out += "{\"name\":\"";
+            appendEscaped(out, event.name);
+            out += "\",\"cat\":\"dBaseEditor\",\"ph\":\"X\",\"ts\":";
+            out += QByteArray::number(double(event.start) / 1000.0, 'f', 3);
+            out += ",\"dur\":";
+            out += QByteArray::number(double(event.duration) / 1000.0, 'f', 3);
+            out += ",\"pid\":" + pid + ",\"tid\":" + tid + '}';
+        }
+
+        const int dropped = buffer->dropped.load(std::memory_order_relaxed);
+        if (dropped > 0) {
+            if (!first)
+                out += ",\n";
+            first = false;
+            out += "{\"name\":\"dropped events\",\"cat\":\"dBaseEditor\",\"ph\":\"i\",\"s\":\"t\",\"ts\":0";
+            out += ",\"pid\":" + pid + ",\"tid\":" + tid;
+            out += ",\"args\":{\"count\":" + QByteArray::number(dropped) + "}}";
+        }
+    }
+    out += "\n]}\n";
+
+    FileSaver saver(fileName, QIODevice::Text);
+    saver.write(out);
+    if (!saver.finalize()) {
+        if (errorMessage)
+            *errorMessage = saver.errorString();
+        return false;
+    }
+    return true;
+}
+
+}  // namespace Trace
+}  // namespace Internal
+}  // namespace dBaseEditor
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <QString>
+
+#include <atomic>
+
+namespace dBaseEditor {
+namespace Internal {
+namespace Trace {
+
+extern std::atomic<bool> g_enabled;
+
+/**
+ * @brief Turns tracing on when DBASE_TRACE_FILE is set in the environment or
+ *        tracing was switched on in the settings.
+ */
+void initialize();
+void shutdown();
+
+inline bool isEnabled() { return g_enabled.load(std::memory_order_relaxed); }
+void setEnabled(bool enabled);
+
+QString traceFile();
+
+/**
+ * @brief Writes all recorded events as Chrome trace-event JSON, which can be
+ *        opened in chrome://tracing or https://ui.perfetto.dev.
+ */
+bool dump(const QString &fileName, QString *errorMessage = 0);
+
+qint64 now();
+void record(const char *name, qint64 start, qint64 end);
+
+/**
+ * @brief Records the lifetime of the enclosing scope. \a name must be a
+ *        string literal; when tracing is off the cost is one relaxed load.
+ */
+class Scope
+{
+public:
+    explicit Scope(const char *name)
+        : m_name(isEnabled() ? name : 0)
+        , m_start(m_name ? now() : 0)
+    {}
+
+    ~Scope()
+    {
+        if (m_name)
+            record(m_name, m_start, now());
+    }
+
+private:
+    Q_DISABLE_COPY(Scope)
+
+    const char *m_name;
+    qint64 m_start;
+};
+
+}  // namespace Trace
+}  // namespace Internal
+}  // namespace dBaseEditor
+
+#define DBASE_TRACE_CONCAT_HELPER(a, b) a##b
+#define DBASE_TRACE_CONCAT(a, b) DBASE_TRACE_CONCAT_HELPER(a, b)
+#define DBASE_TRACE_SCOPE(name) \
+    ::dBaseEditor::Internal::Trace::Scope DBASE_TRACE_CONCAT(dbaseTraceScope, __LINE__)(name)
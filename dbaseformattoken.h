@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QtGlobal>
+
+namespace dBaseEditor {
+namespace Internal {
+
+enum Format {
+    Format_Number = 0,
+    Format_String,
+    Format_Keyword,
+    Format_Preprocessor,
+    Format_Operator,
+    Format_Comment,
+    Format_Identifier,
+    Format_Whitespace,
+
+    Format_FormatsAmount,
+    Format_EndOfBlock
+};
+
+class FormatToken
+{
+public:
+    FormatToken() {}
+
+    FormatToken(Format format, int position, int length)
+        : m_format(format)
+        , m_position(position)
+        , m_length(length)
+    {}
+
+    Format format() const { return m_format; }
+    int begin() const { return m_position; }
+    int end() const { return m_position + m_length; }
+    int length() const { return m_length; }
+
+private:
+    Format m_format = Format_EndOfBlock;
+    int m_position = -1;
+    int m_length = -1;
+};
+
+}  // namespace Internal
+}  // namespace dBaseEditor